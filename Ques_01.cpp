@@ -1,10 +1,18 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <ctime>
 #include <sstream>
 #include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <unordered_map>
+
+#include "instrumentation.h"
+#include "output_buffer.h"
+#include "string_arena.h"
 
 using namespace std;
 
@@ -59,112 +67,201 @@ public:
     BookNotIssuedException(const string& msg) : runtime_error(msg) {}
 };
 
-// Class for Book
+class HoldAlreadyPlacedException : public runtime_error {
+public:
+    HoldAlreadyPlacedException(const string& msg) : runtime_error(msg) {}
+};
+
+// Class for Book. Text fields live in the global StringPool; authors and issue
+// dates are interned since many books share them.
 class Book {
 public:
-    Book(int id, const string& title, const string& author) 
-        : id(id), title(title), author(author), issued(false) {}
+    Book(int id, string_view title, string_view author)
+        : id(id), issued(false), title(StringPool::global().store(title)),
+          author(StringPool::global().intern(author)) {}
 
     int getId() const { return id; }
-    string getTitle() const { return title; }
-    string getAuthor() const { return author; }
+    string_view getTitle() const { return title; }
+    string_view getAuthor() const { return author; }
     bool isIssued() const { return issued; }
-    string getIssueDate() const { return issueDate; }
+    string_view getIssueDate() const { return issueDate; }
 
-    void issue(const string& date) {
+    void issue(string_view date) {
         issued = true;
-        issueDate = date;
+        issueDate = StringPool::global().intern(date);
     }
 
     void returnBook() {
         issued = false;
-        issueDate.clear();
+        issueDate = string_view();
     }
 
 private:
     int id;
-    string title;
-    string author;
     bool issued;
-    string issueDate; // Stores the date when the book was issued
+    string_view title;
+    string_view author;
+    string_view issueDate; // Stores the date when the book was issued
 };
 
 // Class for Member
 class Member {
 public:
-    Member(int id, const string& name) : id(id), name(name) {}
+    Member(int id, string_view name) : id(id), name(StringPool::global().intern(name)) {}
 
     int getId() const { return id; }
-    string getName() const { return name; }
+    string_view getName() const { return name; }
 
 private:
     int id;
-    string name;
+    string_view name;
+};
+
+// FIFO hold queues for every book. Queue nodes come from one shared pool and are
+// recycled through a free list instead of one heap node per hold. The two hash
+// maps still allocate: `tickets` an entry for every hold placed, and `queues`
+// one whenever a book's queue goes from empty to waiting. Each hold takes the
+// next ticket of its book's queue, which makes a member's position the distance
+// from the ticket being served: no walk of the queue, however long it gets.
+class HoldQueues {
+public:
+    // Add `memberId` to the back of `bookId`'s queue; returns its 1-based position
+    size_t add(int bookId, int memberId) {
+        Queue& queue = queues[bookId];
+        uint32_t node = allocate(memberId);
+        if (queue.tail == kNone) {
+            queue.head = node;
+        } else {
+            nodes[queue.tail].next = node;
+        }
+        queue.tail = node;
+        uint64_t ticket = queue.nextTicket++;
+        tickets[key(bookId, memberId)] = ticket;
+        return static_cast<size_t>(ticket - queue.served) + 1;
+    }
+
+    // Remove and return the member at the front of `bookId`'s queue, or -1 if
+    // nobody is waiting
+    int pop(int bookId) {
+        auto found = queues.find(bookId);
+        if (found == queues.end()) return -1;
+        Queue& queue = found->second;
+        uint32_t node = queue.head;
+        int memberId = nodes[node].memberId;
+        queue.head = nodes[node].next;
+        ++queue.served;
+        release(node);
+        tickets.erase(key(bookId, memberId));
+        if (queue.head == kNone) queues.erase(found);
+        return memberId;
+    }
+
+    // 1-based position of `memberId` in `bookId`'s queue, or 0 if not waiting
+    size_t position(int bookId, int memberId) const {
+        auto ticket = tickets.find(key(bookId, memberId));
+        if (ticket == tickets.end()) return 0;
+        return static_cast<size_t>(ticket->second - queues.at(bookId).served) + 1;
+    }
+
+    size_t length(int bookId) const {
+        auto found = queues.find(bookId);
+        return found == queues.end() ? 0 : static_cast<size_t>(found->second.nextTicket - found->second.served);
+    }
+
+private:
+    static const uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        int memberId;
+        uint32_t next;   // index into nodes, or kNone
+    };
+
+    // Only books with someone waiting have a queue
+    struct Queue {
+        uint32_t head = kNone;
+        uint32_t tail = kNone;
+        uint64_t nextTicket = 0;   // ticket for the next hold placed
+        uint64_t served = 0;       // ticket of the hold at the front
+    };
+
+    static uint64_t key(int bookId, int memberId) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(bookId)) << 32) | static_cast<uint32_t>(memberId);
+    }
+
+    uint32_t allocate(int memberId) {
+        uint32_t node;
+        if (freeList != kNone) {
+            node = freeList;
+            freeList = nodes[node].next;
+        } else {
+            node = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(Node());
+        }
+        nodes[node] = Node{memberId, kNone};
+        return node;
+    }
+
+    void release(uint32_t node) {
+        nodes[node].next = freeList;
+        freeList = node;
+    }
+
+    vector<Node> nodes;
+    uint32_t freeList = kNone;
+    unordered_map<int, Queue> queues;
+    unordered_map<uint64_t, uint64_t> tickets;   // (book, member) -> ticket
 };
 
 // Class for Library
 class Library {
 public:
     void addBook(const Book& book) {
+        INSTRUMENT_OP("Library::addBook");
         books.push_back(book);
     }
 
     void addMember(const Member& member) {
+        INSTRUMENT_OP("Library::addMember");
+        memberIndex.emplace(member.getId(), members.size());
         members.push_back(member);
     }
 
     Book& findBook(int id) {
-        for (auto& book : books) {
-            if (book.getId() == id) {
-                return book;
-            }
-        }
-        throw BookNotFoundException("Book not found");
+        INSTRUMENT_OP("Library::findBook");
+        return bookById(id);
     }
 
     const Book& findBook(int id) const {
-        for (const auto& book : books) {
-            if (book.getId() == id) {
-                return book;
-            }
-        }
-        throw BookNotFoundException("Book not found");
+        INSTRUMENT_OP("Library::findBook");
+        return bookById(id);
     }
 
     Member& findMember(int id) {
-        for (auto& member : members) {
-            if (member.getId() == id) {
-                return member;
-            }
-        }
-        throw MemberNotFoundException("Member not found");
+        INSTRUMENT_OP("Library::findMember");
+        return memberById(id);
     }
 
     const Member& findMember(int id) const {
-        for (const auto& member : members) {
-            if (member.getId() == id) {
-                return member;
-            }
-        }
-        throw MemberNotFoundException("Member not found");
+        INSTRUMENT_OP("Library::findMember");
+        return memberById(id);
     }
 
     void issueBook(int bookId, int memberId) {
-        Book& book = findBook(bookId);
-        Member& member = findMember(memberId);
+        INSTRUMENT_OP("Library::issueBook");
+        Book& book = bookById(bookId);
+        memberById(memberId);
 
         if (book.isIssued()) {
             throw BookAlreadyIssuedException("Book is already issued");
         }
 
-        string today = getCurrentDate();
-        book.issue(today);
-        loans.push_back(make_pair(bookId, memberId));
+        lend(book, memberId);
         cout << "Book issued successfully.\n";
     }
 
     void returnBook(int bookId, int memberId) {
-        Book& book = findBook(bookId);
+        INSTRUMENT_OP("Library::returnBook");
+        Book& book = bookById(bookId);
         auto it = find_if(loans.begin(), loans.end(), [bookId, memberId](const pair<int, int>& loan) {
             return loan.first == bookId && loan.second == memberId;
         });
@@ -176,9 +273,52 @@ public:
         book.returnBook();
         loans.erase(it);
         cout << "Book returned successfully.\n";
+
+        // Hand the book straight to the next member waiting for it
+        int next = holds.pop(bookId);
+        if (next >= 0) {
+            lend(book, next);
+            cout << "Book issued to member " << next << " from the hold queue.\n";
+        }
+    }
+
+    // Join the hold queue for an issued book; returns the member's position. A
+    // book on the shelf is issued right away instead, and 0 is returned.
+    size_t placeHold(int bookId, int memberId) {
+        INSTRUMENT_OP("Library::placeHold");
+        Book& book = bookById(bookId);
+        memberById(memberId);
+
+        if (!book.isIssued()) {
+            lend(book, memberId);
+            cout << "Book issued successfully.\n";
+            return 0;
+        }
+        if (holds.position(bookId, memberId) != 0) {
+            throw HoldAlreadyPlacedException("Member is already waiting for this book");
+        }
+        bool borrowing = any_of(loans.begin(), loans.end(), [bookId, memberId](const pair<int, int>& loan) {
+            return loan.first == bookId && loan.second == memberId;
+        });
+        if (borrowing) {
+            throw BookAlreadyIssuedException("Book is already issued to this member");
+        }
+        return holds.add(bookId, memberId);
+    }
+
+    // Position of a member in a book's hold queue (1 = next), or 0 if not waiting
+    size_t holdPosition(int bookId, int memberId) const {
+        INSTRUMENT_OP("Library::holdPosition");
+        return holds.position(bookId, memberId);
+    }
+
+    size_t holdCount(int bookId) const {
+        INSTRUMENT_OP("Library::holdCount");
+        return holds.length(bookId);
     }
 
     void calculateOverdueFees() const {
+        INSTRUMENT_OP("Library::calculateOverdueFees");
         string today = getCurrentDate();
         tm currentDate = stringToTm(today);
         bool flag=false;
@@ -186,9 +326,9 @@ public:
         cout<<"Enter the issued days time\n";
         cin>>days;
         for (const auto& loan : loans) {
-            const Book& book = findBook(loan.first);
+            const Book& book = bookById(loan.first);
             if (book.isIssued()) {
-                tm issueDate = stringToTm(book.getIssueDate());
+                tm issueDate = stringToTm(string(book.getIssueDate()));
                 int overdueDays = calculateDaysDifference(issueDate, currentDate) - days; // Assuming a 2-week loan period
                 if (overdueDays > 0) {
                     flag=true;
@@ -202,28 +342,77 @@ public:
          cout<<"No book is issued for more than "<<days<<" days, no charges applicable on any member\n";
     }
 
-    void listBooks() const {
-        cout << "Books in the library:\n";
+    void listBooks(OutputFormat format = OutputFormat::Text) const {
+        INSTRUMENT_OP("Library::listBooks");
+        static const RecordWriter::Column columns[] = {
+            {"ID", "id"}, {"Title", "title"}, {"Author", "author"},
+            {"Issued", "issued"}, {"Issue Date", "issue_date"}};
+        RecordWriter rows(OutputBuffer::standardOutput(), format);
+        rows.begin("Books in the library:", columns);
         for (const auto& book : books) {
-            cout << "ID: " << book.getId() << ", Title: " << book.getTitle() 
-                 << ", Author: " << book.getAuthor() 
-                 << ", Issued: " << (book.isIssued() ? "Yes" : "No") 
-                 << (book.isIssued() ? ", Issue Date: " + book.getIssueDate() : "") 
-                 << endl;
+            rows.field(book.getId()).field(book.getTitle()).field(book.getAuthor()).flag(book.isIssued());
+            if (book.isIssued()) {
+                rows.field(book.getIssueDate());
+            } else {
+                rows.skip();
+            }
+            rows.endRow();
         }
+        rows.end();
     }
 
-    void listMembers() const {
-        cout << "Members in the library:\n";
+    void listMembers(OutputFormat format = OutputFormat::Text) const {
+        INSTRUMENT_OP("Library::listMembers");
+        static const RecordWriter::Column columns[] = {{"ID", "id"}, {"Name", "name"}};
+        RecordWriter rows(OutputBuffer::standardOutput(), format);
+        rows.begin("Members in the library:", columns);
         for (const auto& member : members) {
-            cout << "ID: " << member.getId() << ", Name: " << member.getName() << endl;
+            rows.field(member.getId()).field(member.getName());
+            rows.endRow();
         }
+        rows.end();
     }
 
 private:
     vector<Book> books;
     vector<Member> members;
+    unordered_map<int, size_t> memberIndex;   // member id -> first member with that id
     vector<pair<int, int>> loans; // (bookId, memberId) pairs
+    HoldQueues holds;
+
+    // Uninstrumented lookups for use inside other operations, so that each
+    // public call is counted once
+    const Book& bookById(int id) const {
+        for (const auto& book : books) {
+            if (book.getId() == id) {
+                return book;
+            }
+        }
+        throw BookNotFoundException("Book not found");
+    }
+
+    Book& bookById(int id) {
+        return const_cast<Book&>(static_cast<const Library*>(this)->bookById(id));
+    }
+
+    const Member& memberById(int id) const {
+        auto found = memberIndex.find(id);
+        if (found == memberIndex.end()) {
+            throw MemberNotFoundException("Member not found");
+        }
+        return members[found->second];
+    }
+
+    Member& memberById(int id) {
+        return const_cast<Member&>(static_cast<const Library*>(this)->memberById(id));
+    }
+
+    // Uninstrumented body of issueBook for a book known to be on the shelf,
+    // shared with placeHold and the hold-queue hand-off in returnBook
+    void lend(Book& book, int memberId) {
+        book.issue(getCurrentDate());
+        loans.push_back(make_pair(book.getId(), memberId));
+    }
 
     int calculateDaysDifference(const tm& start, const tm& end) const {
         time_t start_time = mktime(const_cast<tm*>(&start));
@@ -233,10 +422,15 @@ private:
     }
 };
 
+// Define NO_MAIN to include this file from another program (see benchmark.cpp)
+#ifndef NO_MAIN
 // Main function
 int main() {
     Library library;
     int choice;
+#ifdef ENABLE_INSTRUMENTATION
+    Instrumentation::installDumpSignal(SIGUSR1);
+#endif
 
     do {
         cout << "\nLibrary Management System\n";
@@ -248,6 +442,11 @@ int main() {
         cout << "6. List Books\n";
         cout << "7. List Members\n";
         cout << "8. Exit\n";
+#ifdef ENABLE_INSTRUMENTATION
+        cout << "9. Show Statistics\n";
+#endif
+        cout << "10. Place Hold\n";
+        cout << "11. Check Hold Position\n";
         cout << "Enter your choice: ";
         cin >> choice;
 
@@ -312,6 +511,37 @@ int main() {
                 case 8:
                     cout << "Exiting...\n";
                     break;
+#ifdef ENABLE_INSTRUMENTATION
+                case 9:
+                    Instrumentation::dump(cout);
+                    break;
+#endif
+                case 10: {
+                    int bookId, memberId;
+                    cout << "Enter book ID to hold: ";
+                    cin >> bookId;
+                    cout << "Enter member ID placing the hold: ";
+                    cin >> memberId;
+                    size_t position = library.placeHold(bookId, memberId);
+                    if (position > 0) {
+                        cout << "Hold placed. Position in queue: " << position << "\n";
+                    }
+                    break;
+                }
+                case 11: {
+                    int bookId, memberId;
+                    cout << "Enter book ID: ";
+                    cin >> bookId;
+                    cout << "Enter member ID: ";
+                    cin >> memberId;
+                    size_t position = library.holdPosition(bookId, memberId);
+                    if (position > 0) {
+                        cout << "Position in queue: " << position << " of " << library.holdCount(bookId) << "\n";
+                    } else {
+                        cout << "Member is not waiting for this book.\n";
+                    }
+                    break;
+                }
                 default:
                     cout << "Invalid choice. Please try again.\n";
             }
@@ -322,3 +552,4 @@ int main() {
 
     return 0;
 }
+#endif // NO_MAIN
@@ -1,4 +1,7 @@
 #include <bits/stdc++.h>
+#include "instrumentation.h"
+#include "output_buffer.h"
+#include "string_arena.h"
 using namespace std;
 
 // Date class to handle booking dates
@@ -39,6 +42,30 @@ public:
         return tie(year, month, day) <= tie(other.year, other.month, other.day);
     }
 
+    // Days since 1970-01-01 in the proleptic Gregorian calendar
+    long toDayNumber() const {
+        int y = year - (month <= 2 ? 1 : 0);
+        long era = (y >= 0 ? y : y - 399) / 400;
+        long yoe = y - era * 400;
+        long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    // Inverse of toDayNumber
+    static Date fromDayNumber(long days) {
+        days += 719468;
+        long era = (days >= 0 ? days : days - 146096) / 146097;
+        long doe = days - era * 146097;
+        long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        long mp = (5 * doy + 2) / 153;
+        int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        int y = static_cast<int>(yoe + era * 400 + (m <= 2 ? 1 : 0));
+        return Date(d, m, y);
+    }
+
     // Check if two date ranges overlap
     static bool doDatesOverlap(const Date& start1, const Date& end1, const Date& start2, const Date& end2) {
         return start1.isBeforeOrEqual(end2) && start2.isBeforeOrEqual(end1);
@@ -64,32 +91,32 @@ public:
     RoomNotBookedException(const string& msg) : runtime_error(msg) {}
 };
 
-// Base class for Room
+// Base class for Room. A room may hold several bookings as long as their dates
+// do not overlap; Hotel keeps the per-room calendar and checks that.
 class Room {
 public:
-    Room(int id, double price) : id(id), price(price), booked(false) {}
+    Room(int id, double price) : id(id), price(price), activeBookings(0) {}
 
     virtual ~Room() = default;
 
     int getId() const { return id; }
     double getPrice() const { return price; }
-    bool isBooked() const { return booked; }
-    virtual string getType() const = 0; // Pure virtual function
+    bool isBooked() const { return activeBookings > 0; }
+    virtual string_view getType() const = 0; // Pure virtual function
 
     void book() {
-        if (booked) throw RoomAlreadyBookedException("Room already booked.");
-        booked = true;
+        ++activeBookings;
     }
 
     void cancel() {
-        if (!booked) throw RoomNotBookedException("Room was not booked.");
-        booked = false;
+        if (activeBookings == 0) throw RoomNotBookedException("Room was not booked.");
+        --activeBookings;
     }
 
 private:
     int id;
     double price;
-    bool booked;
+    int activeBookings;
 };
 
 // Derived classes for specific types of rooms
@@ -97,7 +124,7 @@ class SingleRoom : public Room {
 public:
     SingleRoom(int id, double price) : Room(id, price) {}
 
-    string getType() const override {
+    string_view getType() const override {
         return "Single";
     }
 };
@@ -106,7 +133,7 @@ class DoubleRoom : public Room {
 public:
     DoubleRoom(int id, double price) : Room(id, price) {}
 
-    string getType() const override {
+    string_view getType() const override {
         return "Double";
     }
 };
@@ -115,22 +142,22 @@ class SuiteRoom : public Room {
 public:
     SuiteRoom(int id, double price) : Room(id, price) {}
 
-    string getType() const override {
+    string_view getType() const override {
         return "Suite";
     }
 };
 
-// Class for Customer
+// Class for Customer; the name is interned in the global StringPool
 class Customer {
 public:
-    Customer(int id, const string& name) : id(id), name(name) {}
+    Customer(int id, string_view name) : id(id), name(StringPool::global().intern(name)) {}
 
     int getId() const { return id; }
-    string getName() const { return name; }
+    string_view getName() const { return name; }
 
 private:
     int id;
-    string name;
+    string_view name;
 };
 
 // Class for Booking
@@ -151,18 +178,337 @@ private:
     Date endDate;
 };
 
+// Fenwick tree over [0, n) supporting range add and range sum in O(log n),
+// using the usual pair of trees for the linear and constant terms
+class RangeFenwick {
+public:
+    explicit RangeFenwick(int n) : linear(n + 1, 0), constant(n + 1, 0) {}
+
+    // Add `value` to every position in [first, last]
+    void add(int first, int last, long long value) {
+        update(first + 1, value);
+        update(last + 2, -value);
+    }
+
+    // Sum of positions in [first, last]
+    long long sum(int first, int last) const {
+        return prefix(last + 1) - prefix(first);
+    }
+
+private:
+    void update(int i, long long value) {
+        long long scaled = value * (i - 1);
+        for (int j = i; j < static_cast<int>(linear.size()); j += j & -j) {
+            linear[j] += value;
+            constant[j] += scaled;
+        }
+    }
+
+    // Sum of the first `i` positions
+    long long prefix(int i) const {
+        long long a = 0, b = 0;
+        for (int j = i; j > 0; j -= j & -j) {
+            a += linear[j];
+            b += constant[j];
+        }
+        return a * i - b;
+    }
+
+    vector<long long> linear;
+    vector<long long> constant;
+};
+
+// Point-update, prefix-sum Fenwick tree over 2^kBits indices that stores only
+// the nodes some update has reached: each distinct index costs kBits nodes, so a
+// handful of far-apart indices never pay for the gap between them
+template <typename T>
+class SparseFenwick {
+public:
+    static const int kBits = 34;
+
+    void add(uint64_t index, const T& value) {
+        for (uint64_t j = index + 1; j <= kSize; j += j & (~j + 1)) {
+            nodes[j] += value;
+        }
+    }
+
+    // Sum of indices [first, last]
+    T sum(uint64_t first, uint64_t last) const {
+        T total = prefix(last + 1);
+        total -= prefix(first);
+        return total;
+    }
+
+private:
+    static const uint64_t kSize = uint64_t(1) << kBits;
+
+    // Sum of the first `count` indices
+    T prefix(uint64_t count) const {
+        T total{};
+        for (uint64_t j = count; j > 0; j -= j & (~j + 1)) {
+            auto found = nodes.find(j);
+            if (found != nodes.end()) total += found->second;
+        }
+        return total;
+    }
+
+    unordered_map<uint64_t, T> nodes;
+};
+
+// Revenue figures for one room type (or all types) over a date range
+struct RevenueSummary {
+    double revenue = 0;            // total room revenue
+    long long roomNights = 0;      // occupied room-nights
+    long long availableNights = 0; // rooms of the type x days in range
+    double occupancy() const { return availableNights ? double(roomNights) / availableNights : 0; }
+    double adr() const { return roomNights ? revenue / roomNights : 0; }        // average daily rate
+    double revPar() const { return availableNights ? revenue / availableNights : 0; } // revenue per available room
+};
+
+// One entry of a batch booking: any room of `roomType` priced at most `maxPrice`
+struct BookingRequest {
+    int customerId;
+    string roomType;
+    double maxPrice;
+    Date startDate;
+    Date endDate;
+};
+
 // Class for Hotel
 class Hotel {
 public:
     void addRoom(shared_ptr<Room> room) {
+        INSTRUMENT_OP("Hotel::addRoom");
         rooms.push_back(room);
+        ++analytics[string(room->getType())].roomCount;
+        // Keep each type's rooms ordered by price for assignRooms
+        vector<shared_ptr<Room>>& sameType = roomsByType[string(room->getType())];
+        auto position = upper_bound(sameType.begin(), sameType.end(), room,
+                                    [](const shared_ptr<Room>& a, const shared_ptr<Room>& b) {
+                                        return a->getPrice() < b->getPrice();
+                                    });
+        sameType.insert(position, room);
     }
 
     void addCustomer(shared_ptr<Customer> customer) {
+        INSTRUMENT_OP("Hotel::addCustomer");
         customers.push_back(customer);
     }
 
     shared_ptr<Room> findRoom(int id) const {
+        INSTRUMENT_OP("Hotel::findRoom");
+        return roomById(id);
+    }
+
+    shared_ptr<Customer> findCustomer(int id) const {
+        INSTRUMENT_OP("Hotel::findCustomer");
+        return customerById(id);
+    }
+
+    void bookRoom(int roomId, int customerId, Date startDate, Date endDate) {
+        INSTRUMENT_OP("Hotel::bookRoom");
+        shared_ptr<Room> room = roomById(roomId);
+        shared_ptr<Customer> customer = customerById(customerId);
+
+        if (endDate.isBefore(startDate)) {
+            throw invalid_argument("End date is before start date.");
+        }
+
+        // Check for overlapping bookings
+        if (placementGap(roomId, startDate.toDayNumber(), endDate.toDayNumber()) < 0) {
+            throw RoomAlreadyBookedException("Room is booked for the given date range.");
+        }
+
+        bookStay(room, customer, startDate, endDate);
+    }
+
+    // Cancel the stay in room `roomId` that starts on `startDate`
+    void cancelBooking(int roomId, const Date& startDate) {
+        INSTRUMENT_OP("Hotel::cancelBooking");
+        long startDay = startDate.toDayNumber();
+        auto it = find_if(bookings.begin(), bookings.end(), [roomId, startDay](const shared_ptr<Booking>& booking) {
+            return booking->getRoom()->getId() == roomId && booking->getStartDate().toDayNumber() == startDay;
+        });
+
+        if (it == bookings.end()) {
+            throw RoomNotBookedException("Room was not booked from that date");
+        }
+
+        (*it)->getRoom()->cancel();
+        calendars[roomId].erase(startDay);
+        recordStay(**it, -1);
+        bookings.erase(it);
+    }
+
+    // Rooms of `type` ("" for any) priced at most `maxPrice` that are free for
+    // the whole of [startDate, endDate]
+    vector<shared_ptr<Room>> findAvailableRooms(const string& type, double maxPrice,
+                                                const Date& startDate, const Date& endDate) const {
+        INSTRUMENT_OP("Hotel::findAvailableRooms");
+        long first = startDate.toDayNumber();
+        long last = endDate.toDayNumber();
+        vector<shared_ptr<Room>> available;
+        for (const auto& room : rooms) {
+            if (room->getPrice() <= maxPrice && (type.empty() || room->getType() == type) &&
+                placementGap(room->getId(), first, last) >= 0) {
+                available.push_back(room);
+            }
+        }
+        return available;
+    }
+
+    // Book a batch of requests in one pass, choosing concrete rooms best-fit:
+    // requests are taken in order of checkout (the interval-scheduling order that
+    // lets the most stays fit) and each goes to the eligible room whose existing
+    // bookings it sits closest to, leaving the fewest unsellable nights either
+    // side; ties go to the dearest room the guest can afford, keeping cheap rooms
+    // free for tighter budgets. Returns the room id given to each request, or -1
+    // where no room of that type and price was free (or the request itself was
+    // invalid).
+    vector<int> assignRooms(const vector<BookingRequest>& requests) {
+        INSTRUMENT_OP("Hotel::assignRooms");
+        vector<size_t> order(requests.size());
+        iota(order.begin(), order.end(), 0);
+        vector<long> firstDay(requests.size()), lastDay(requests.size());
+        for (size_t i = 0; i < requests.size(); ++i) {
+            firstDay[i] = requests[i].startDate.toDayNumber();
+            lastDay[i] = requests[i].endDate.toDayNumber();
+        }
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            if (lastDay[a] != lastDay[b]) return lastDay[a] < lastDay[b];
+            return firstDay[a] > firstDay[b];
+        });
+
+        vector<int> assigned(requests.size(), -1);
+        for (size_t i : order) {
+            const BookingRequest& request = requests[i];
+            if (lastDay[i] < firstDay[i]) continue;
+            auto candidates = roomsByType.find(request.roomType);
+            if (candidates == roomsByType.end()) continue;
+            const shared_ptr<Customer>& customer = customerOrNull(request.customerId);
+            if (!customer) continue;
+
+            shared_ptr<Room> best;
+            long bestGap = 0;
+            for (const auto& room : candidates->second) {
+                if (room->getPrice() > request.maxPrice) break;   // sorted by price
+                long gap = placementGap(room->getId(), firstDay[i], lastDay[i]);
+                if (gap >= 0 && (!best || gap <= bestGap)) {
+                    best = room;
+                    bestGap = gap;
+                }
+            }
+            if (best) {
+                bookStay(best, customer, request.startDate, request.endDate);
+                assigned[i] = best->getId();
+            }
+        }
+        return assigned;
+    }
+
+    // Baseline for assignRooms: requests in arrival order, each to the first room
+    // (in the order rooms were added) that fits
+    vector<int> assignRoomsFirstFit(const vector<BookingRequest>& requests) {
+        INSTRUMENT_OP("Hotel::assignRoomsFirstFit");
+        vector<int> assigned(requests.size(), -1);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const BookingRequest& request = requests[i];
+            long first = request.startDate.toDayNumber();
+            long last = request.endDate.toDayNumber();
+            if (last < first) continue;
+            const shared_ptr<Customer>& customer = customerOrNull(request.customerId);
+            if (!customer) continue;
+            for (const auto& room : rooms) {
+                if (room->getType() == request.roomType && room->getPrice() <= request.maxPrice &&
+                    placementGap(room->getId(), first, last) >= 0) {
+                    bookStay(room, customer, request.startDate, request.endDate);
+                    assigned[i] = room->getId();
+                    break;
+                }
+            }
+        }
+        return assigned;
+    }
+
+    void listRooms(OutputFormat format = OutputFormat::Text) const {
+        INSTRUMENT_OP("Hotel::listRooms");
+        static const RecordWriter::Column columns[] = {
+            {"ID", "id"}, {"Type", "type"}, {"Price", "price"}, {"Booked", "booked"}};
+        RecordWriter rows(OutputBuffer::standardOutput(), format);
+        rows.begin("Rooms in the hotel:", columns);
+        for (const auto& room : rooms) {
+            rows.field(room->getId()).field(room->getType()).money(room->getPrice()).flag(room->isBooked());
+            rows.endRow();
+        }
+        rows.end();
+    }
+
+    void listCustomers(OutputFormat format = OutputFormat::Text) const {
+        INSTRUMENT_OP("Hotel::listCustomers");
+        static const RecordWriter::Column columns[] = {{"ID", "id"}, {"Name", "name"}};
+        RecordWriter rows(OutputBuffer::standardOutput(), format);
+        rows.begin("Customers in the hotel:", columns);
+        for (const auto& customer : customers) {
+            rows.field(customer->getId()).field(customer->getName());
+            rows.endRow();
+        }
+        rows.end();
+    }
+
+    // Revenue, occupancy, ADR and RevPAR for one room type ("" for all types)
+    // over [from, to] inclusive. O(log n) per type whatever the range length or
+    // booking count: the two edge blocks come from their own trees and every
+    // whole block between them from one range sum over the block totals.
+    RevenueSummary revenueSummary(const string& type, const Date& from, const Date& to) const {
+        INSTRUMENT_OP("Hotel::revenueSummary");
+        long first = from.toDayNumber();
+        long last = to.toDayNumber();
+        if (last < first) {
+            throw invalid_argument("End date is before start date.");
+        }
+        RevenueSummary summary;
+        for (const auto& entry : analytics) {
+            if (!type.empty() && entry.first != type) continue;
+            const TypeAnalytics& stats = entry.second;
+            summary.availableNights += static_cast<long long>(stats.roomCount) * (last - first + 1);
+            long firstBlock = blockOf(first);
+            long lastBlock = blockOf(last);
+            StayTotals totals = stats.partialBlock(firstBlock, first, min(last, (firstBlock + 1) * kBlockDays - 1));
+            if (lastBlock != firstBlock) {
+                totals += stats.partialBlock(lastBlock, lastBlock * kBlockDays, last);
+            }
+            if (lastBlock - firstBlock > 1) {
+                totals += stats.blockTotals.sum(outerIndex(firstBlock + 1), outerIndex(lastBlock - 1));
+            }
+            summary.revenue += totals.revenueCents / 100.0;
+            summary.roomNights += totals.roomNights;
+        }
+        return summary;
+    }
+
+    RevenueSummary revenueForMonth(const string& type, int month, int year) const {
+        Date next = month == 12 ? Date(1, 1, year + 1) : Date(1, month + 1, year);
+        return revenueSummary(type, Date(1, month, year), Date::fromDayNumber(next.toDayNumber() - 1));
+    }
+
+    void printRevenueReport(const Date& from, const Date& to) const {
+        INSTRUMENT_OP("Hotel::printRevenueReport");
+        cout << "Revenue from " << from.toString() << " to " << to.toString() << ":\n";
+        ios_base::fmtflags flags = cout.flags();
+        streamsize precision = cout.precision();
+        cout << fixed << setprecision(2);
+        for (const auto& entry : analytics) {
+            printSummaryRow(entry.first, revenueSummary(entry.first, from, to));
+        }
+        printSummaryRow("All", revenueSummary("", from, to));
+        cout.flags(flags);
+        cout.precision(precision);
+    }
+
+private:
+    // Uninstrumented lookups for use inside other operations, so that each
+    // public call is counted once
+    const shared_ptr<Room>& roomById(int id) const {
         for (auto& room : rooms) {
             if (room->getId() == id) {
                 return room;
@@ -171,74 +517,450 @@ public:
         throw RoomNotFoundException("Room not found");
     }
 
-    shared_ptr<Customer> findCustomer(int id) const {
+    const shared_ptr<Customer>& customerById(int id) const {
+        const shared_ptr<Customer>& customer = customerOrNull(id);
+        if (!customer) {
+            throw runtime_error("Customer not found");
+        }
+        return customer;
+    }
+
+    // Same search without the exception, for batch work that skips unknown ids
+    const shared_ptr<Customer>& customerOrNull(int id) const {
+        static const shared_ptr<Customer> none;
         for (auto& customer : customers) {
             if (customer->getId() == id) {
                 return customer;
             }
         }
-        throw runtime_error("Customer not found");
+        return none;
     }
 
-    void bookRoom(int roomId, int customerId, Date startDate, Date endDate) {
-        shared_ptr<Room> room = findRoom(roomId);
-        shared_ptr<Customer> customer = findCustomer(customerId);
-
-        if (room->isBooked()) {
-            // Check for overlapping bookings
-            for (const auto& booking : bookings) {
-                if (booking->getRoom()->getId() == roomId &&
-                    Date::doDatesOverlap(startDate, endDate, booking->getStartDate(), booking->getEndDate())) {
-                    throw RoomAlreadyBookedException("Room is booked for the given date range.");
-                }
-            }
+    // Gap charged for a side of a stay with no neighbouring booking, so rooms that
+    // already have nearby bookings win over empty ones
+    static constexpr long kOpenGap = 366;
+
+    // Free days left between [first, last] and the room's neighbouring bookings
+    // (day numbers, inclusive), or -1 if the range overlaps an existing booking
+    long placementGap(int roomId, long first, long last) const {
+        auto found = calendars.find(roomId);
+        if (found == calendars.end() || found->second.empty()) return 2 * kOpenGap;
+        const map<long, long>& calendar = found->second;
+        auto next = calendar.upper_bound(last);
+        long gapBefore = kOpenGap;
+        if (next != calendar.begin()) {
+            long previousEnd = prev(next)->second;
+            if (previousEnd >= first) return -1;
+            gapBefore = min(kOpenGap, first - previousEnd - 1);
         }
+        long gapAfter = next == calendar.end() ? kOpenGap : min(kOpenGap, next->first - last - 1);
+        return gapBefore + gapAfter;
+    }
 
+    // Uninstrumented body of bookRoom for a stay already checked to be valid and
+    // free, shared with the batch assigners
+    void bookStay(const shared_ptr<Room>& room, const shared_ptr<Customer>& customer,
+                  Date startDate, Date endDate) {
         room->book();
         bookings.push_back(make_shared<Booking>(room, customer, startDate, endDate));
-        cout << "Room booked successfully from " << startDate.toString() << " to " << endDate.toString() << ".\n";
+        calendars[room->getId()][startDate.toDayNumber()] = endDate.toDayNumber();
+        recordStay(*bookings.back(), 1);
     }
 
-    void cancelBooking(int roomId) {
-        auto it = find_if(bookings.begin(), bookings.end(), [roomId](const shared_ptr<Booking>& booking) {
-            return booking->getRoom()->getId() == roomId;
-        });
+    // Analytics calendar: nights are grouped into blocks of kBlockDays days, each
+    // with its own Fenwick trees, created the first time a stay touches it. Only
+    // the stretches of the calendar that hold bookings take any memory.
+    static const long kBlockDays = 256;
 
-        if (it == bookings.end()) {
-            throw RoomNotBookedException("Room was not booked");
+    struct CalendarBlock {
+        CalendarBlock() : revenueCents(kBlockDays), occupiedRooms(kBlockDays) {}
+        RangeFenwick revenueCents;
+        RangeFenwick occupiedRooms;
+    };
+
+    struct StayTotals {
+        long long revenueCents = 0;
+        long long roomNights = 0;
+
+        StayTotals& operator+=(const StayTotals& other) {
+            revenueCents += other.revenueCents;
+            roomNights += other.roomNights;
+            return *this;
         }
 
-        (*it)->getRoom()->cancel();
-        bookings.erase(it);
-        cout << "Booking cancelled successfully.\n";
-    }
+        StayTotals& operator-=(const StayTotals& other) {
+            revenueCents -= other.revenueCents;
+            roomNights -= other.roomNights;
+            return *this;
+        }
+    };
 
-    void listRooms() const {
-        cout << "Rooms in the hotel:\n";
-        for (const auto& room : rooms) {
-            cout << "ID: " << room->getId() << ", Type: " << room->getType() 
-                 << ", Price: $" << room->getPrice() 
-                 << ", Booked: " << (room->isBooked() ? "Yes" : "No") << endl;
+    // Per-type nightly revenue and occupied-room counts, plus each block's totals
+    // so that whole blocks are summed without visiting them
+    struct TypeAnalytics {
+        int roomCount = 0;
+        map<long, CalendarBlock> blocks;       // keyed by blockOf(day)
+        SparseFenwick<StayTotals> blockTotals; // keyed by outerIndex(block)
+
+        // Totals for the days [first, last], all inside `block`
+        StayTotals partialBlock(long block, long first, long last) const {
+            StayTotals totals;
+            auto found = blocks.find(block);
+            if (found == blocks.end()) return totals;
+            int begin = static_cast<int>(first - block * kBlockDays);
+            int end = static_cast<int>(last - block * kBlockDays);
+            totals.revenueCents = found->second.revenueCents.sum(begin, end);
+            totals.roomNights = found->second.occupiedRooms.sum(begin, end);
+            return totals;
         }
+    };
+
+    static long blockOf(long day) {
+        return day >= 0 ? day / kBlockDays : -((-day + kBlockDays - 1) / kBlockDays);
     }
 
-    void listCustomers() const {
-        cout << "Customers in the hotel:\n";
-        for (const auto& customer : customers) {
-            cout << "ID: " << customer->getId() << ", Name: " << customer->getName() << endl;
+    // Block index shifted to be non-negative. Any Date with an int year lies
+    // within about 3.1e9 blocks of 1970, inside the 2^33 either side allowed here.
+    static uint64_t outerIndex(long block) {
+        return static_cast<uint64_t>(block + (1L << (SparseFenwick<StayTotals>::kBits - 1)));
+    }
+
+    // A stay occupies the nights [start, end); a same-day booking counts as one night
+    void recordStay(const Booking& booking, int sign) {
+        TypeAnalytics& stats = analytics[string(booking.getRoom()->getType())];
+        long first = booking.getStartDate().toDayNumber();
+        long last = max(first, booking.getEndDate().toDayNumber() - 1);
+        long long cents = sign * llround(booking.getRoom()->getPrice() * 100);
+        for (long block = blockOf(first); block <= blockOf(last); ++block) {
+            long blockStart = block * kBlockDays;
+            int begin = static_cast<int>(max(first, blockStart) - blockStart);
+            int end = static_cast<int>(min(last, blockStart + kBlockDays - 1) - blockStart);
+            CalendarBlock& calendar = stats.blocks[block];
+            calendar.revenueCents.add(begin, end, cents);
+            calendar.occupiedRooms.add(begin, end, sign);
+            long nights = end - begin + 1;
+            stats.blockTotals.add(outerIndex(block), StayTotals{cents * nights, sign * nights});
         }
     }
 
-private:
+    static void printSummaryRow(const string& type, const RevenueSummary& summary) {
+        cout << "Type: " << type
+             << ", Revenue: $" << summary.revenue
+             << ", Room-nights: " << summary.roomNights << "/" << summary.availableNights
+             << ", Occupancy: " << summary.occupancy() * 100 << "%"
+             << ", ADR: $" << summary.adr()
+             << ", RevPAR: $" << summary.revPar() << endl;
+    }
+
     vector<shared_ptr<Room>> rooms;
     vector<shared_ptr<Customer>> customers;
     vector<shared_ptr<Booking>> bookings;
+    map<string, TypeAnalytics> analytics;   // keyed by Room::getType()
+    map<string, vector<shared_ptr<Room>>> roomsByType;   // each sorted by price
+    unordered_map<int, map<long, long>> calendars;       // room id -> start day -> end day
+};
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov). Producers
+// only swap the head pointer; the single consumer owns the tail.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(new Node()), tail(head.load(memory_order_relaxed)) {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        while (tail) {
+            Node* next = tail->next.load(memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+
+    // Any thread
+    void push(T value) {
+        Node* node = new Node();
+        node->value = move(value);
+        Node* prev = head.exchange(node, memory_order_acq_rel);
+        prev->next.store(node, memory_order_release);
+    }
+
+    // Consumer thread only
+    bool pop(T& out) {
+        Node* next = tail->next.load(memory_order_acquire);
+        if (!next) return false;
+        out = move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    // Consumer thread only
+    bool empty() const {
+        return tail->next.load(memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    atomic<Node*> head;
+    Node* tail;
+};
+
+// A room found by a chain-wide search
+struct ChainRoom {
+    int propertyId;
+    int roomId;
+    string type;
+    double price;
 };
 
+// Hotel chain partitioned by property into shards. Each shard's hotels are
+// touched only by that shard's worker thread, so they need no locking; callers
+// post work through the shard's MPSC queue and get a future back. Queries that
+// span the chain fan out to every shard and merge the results.
+class HotelChain {
+public:
+    explicit HotelChain(int shardCount) {
+        if (shardCount <= 0) {
+            throw invalid_argument("Shard count must be positive.");
+        }
+        for (int i = 0; i < shardCount; ++i) {
+            shards.emplace_back(new Shard());
+        }
+    }
+
+    HotelChain(const HotelChain&) = delete;
+    HotelChain& operator=(const HotelChain&) = delete;
+
+    int getShardCount() const { return static_cast<int>(shards.size()); }
+
+    future<void> addProperty(int propertyId) {
+        return submit<void>(propertyId, [propertyId](Shard& shard) {
+            if (shard.properties.count(propertyId)) {
+                throw runtime_error("Property already exists");
+            }
+            Hotel& hotel = shard.properties[propertyId];
+            for (const auto& customer : shard.customers) {
+                hotel.addCustomer(customer);
+            }
+        });
+    }
+
+    future<void> addRoom(int propertyId, shared_ptr<Room> room) {
+        return submit<void>(propertyId, [propertyId, room](Shard& shard) {
+            shard.property(propertyId).addRoom(room);
+        });
+    }
+
+    future<ChainRoom> findRoom(int propertyId, int roomId) {
+        return submit<ChainRoom>(propertyId, [propertyId, roomId](Shard& shard) {
+            shared_ptr<Room> room = shard.property(propertyId).findRoom(roomId);
+            return ChainRoom{propertyId, room->getId(), string(room->getType()), room->getPrice()};
+        });
+    }
+
+    // Customers are chain-wide: every shard registers them with all its properties
+    void addCustomer(shared_ptr<Customer> customer) {
+        fanOut<void>([customer](Shard& shard) {
+            shard.customers.push_back(customer);
+            for (auto& entry : shard.properties) {
+                entry.second.addCustomer(customer);
+            }
+        });
+    }
+
+    future<void> bookRoom(int propertyId, int roomId, int customerId, Date startDate, Date endDate) {
+        return submit<void>(propertyId, [=](Shard& shard) {
+            shard.property(propertyId).bookRoom(roomId, customerId, startDate, endDate);
+        });
+    }
+
+    future<void> cancelBooking(int propertyId, int roomId, Date startDate) {
+        return submit<void>(propertyId, [=](Shard& shard) {
+            shard.property(propertyId).cancelBooking(roomId, startDate);
+        });
+    }
+
+    // Cheapest rooms free for [startDate, endDate] across every property, at most
+    // `limit` of them
+    vector<ChainRoom> findAvailableRooms(const string& type, double maxPrice, const Date& startDate,
+                                         const Date& endDate, size_t limit) {
+        vector<vector<ChainRoom>> perShard = fanOut<vector<ChainRoom>>([=](Shard& shard) {
+            vector<ChainRoom> found;
+            for (const auto& entry : shard.properties) {
+                for (const auto& room : entry.second.findAvailableRooms(type, maxPrice, startDate, endDate)) {
+                    found.push_back(ChainRoom{entry.first, room->getId(), string(room->getType()), room->getPrice()});
+                }
+            }
+            return found;
+        });
+
+        vector<ChainRoom> merged;
+        for (auto& found : perShard) {
+            merged.insert(merged.end(), found.begin(), found.end());
+        }
+        auto byPrice = [](const ChainRoom& a, const ChainRoom& b) {
+            return tie(a.price, a.propertyId, a.roomId) < tie(b.price, b.propertyId, b.roomId);
+        };
+        if (merged.size() > limit) {
+            partial_sort(merged.begin(), merged.begin() + limit, merged.end(), byPrice);
+            merged.resize(limit);
+        } else {
+            sort(merged.begin(), merged.end(), byPrice);
+        }
+        return merged;
+    }
+
+    // Chain-wide revenue for a room type ("" for all) over [from, to]
+    RevenueSummary revenueSummary(const string& type, const Date& from, const Date& to) {
+        RevenueSummary total;
+        for (const auto& part : fanOut<RevenueSummary>([=](Shard& shard) {
+                 RevenueSummary sum;
+                 for (const auto& entry : shard.properties) {
+                     RevenueSummary one = entry.second.revenueSummary(type, from, to);
+                     sum.revenue += one.revenue;
+                     sum.roomNights += one.roomNights;
+                     sum.availableNights += one.availableNights;
+                 }
+                 return sum;
+             })) {
+            total.revenue += part.revenue;
+            total.roomNights += part.roomNights;
+            total.availableNights += part.availableNights;
+        }
+        return total;
+    }
+
+private:
+    // One partition of the chain and the worker thread that owns it
+    struct Shard {
+        Shard() : idle(false), stopping(false), worker([this] { run(); }) {}
+
+        ~Shard() {
+            post([this](Shard&) { stopping = true; });
+            worker.join();
+        }
+
+        Hotel& property(int propertyId) {
+            auto it = properties.find(propertyId);
+            if (it == properties.end()) {
+                throw runtime_error("Property not found");
+            }
+            return it->second;
+        }
+
+        void post(function<void(Shard&)> task) {
+            tasks.push(move(task));
+            // Only wake the worker if it has gone to sleep. The push ends in a
+            // release store, which may otherwise be reordered after the load of
+            // idle; the fence pairs with the one in run()
+            atomic_thread_fence(memory_order_seq_cst);
+            if (idle.load()) {
+                lock_guard<mutex> lock(wakeMutex);
+                wake.notify_one();
+            }
+        }
+
+        void run() {
+            function<void(Shard&)> task;
+            while (!stopping) {
+                if (tasks.pop(task)) {
+                    task(*this);
+                    continue;
+                }
+                // Spin briefly before sleeping, then re-check after announcing idle
+                // so a push that missed the flag is never lost
+                bool found = false;
+                for (int spin = 0; spin < 64 && !found; ++spin) {
+                    this_thread::yield();
+                    found = !tasks.empty();
+                }
+                if (found) continue;
+                unique_lock<mutex> lock(wakeMutex);
+                idle.store(true);
+                atomic_thread_fence(memory_order_seq_cst);
+                wake.wait(lock, [this] { return !tasks.empty(); });
+                idle.store(false);
+            }
+        }
+
+        // Owned by the worker thread
+        map<int, Hotel> properties;
+        vector<shared_ptr<Customer>> customers;
+
+        MpscQueue<function<void(Shard&)>> tasks;
+        atomic<bool> idle;
+        mutex wakeMutex;
+        condition_variable wake;
+        bool stopping;
+        thread worker;
+    };
+
+    Shard& shardFor(int propertyId) {
+        return *shards[static_cast<unsigned>(propertyId) % shards.size()];
+    }
+
+    template <typename R, typename F>
+    static void fulfil(promise<R>& result, F& work, Shard& shard) {
+        try {
+            if constexpr (is_void<R>::value) {
+                work(shard);
+                result.set_value();
+            } else {
+                result.set_value(work(shard));
+            }
+        } catch (...) {
+            result.set_exception(current_exception());
+        }
+    }
+
+    template <typename R, typename F>
+    future<R> submit(int propertyId, F work) {
+        auto result = make_shared<promise<R>>();
+        future<R> done = result->get_future();
+        shardFor(propertyId).post([result, work](Shard& shard) mutable {
+            fulfil(*result, work, shard);
+        });
+        return done;
+    }
+
+    // Run `work` on every shard in parallel and collect the results in shard order
+    template <typename R, typename F>
+    typename conditional<is_void<R>::value, void, vector<R>>::type fanOut(F work) {
+        vector<future<R>> pending;
+        for (auto& shard : shards) {
+            auto result = make_shared<promise<R>>();
+            pending.push_back(result->get_future());
+            shard->post([result, work](Shard& target) mutable {
+                fulfil(*result, work, target);
+            });
+        }
+        if constexpr (is_void<R>::value) {
+            for (auto& done : pending) done.get();
+        } else {
+            vector<R> results;
+            for (auto& done : pending) results.push_back(done.get());
+            return results;
+        }
+    }
+
+    vector<unique_ptr<Shard>> shards;
+};
+
+// Define NO_MAIN to include this file from another program (see benchmark.cpp)
+#ifndef NO_MAIN
 // Main function
 int main() {
     Hotel hotel;
     int choice;
+#ifdef ENABLE_INSTRUMENTATION
+    Instrumentation::installDumpSignal(SIGUSR1);
+#endif
 
     do {
         cout << "\nHotel Booking System\n";
@@ -249,6 +971,10 @@ int main() {
         cout << "5. List Rooms\n";
         cout << "6. List Customers\n";
         cout << "7. Exit\n";
+#ifdef ENABLE_INSTRUMENTATION
+        cout << "8. Show Statistics\n";
+#endif
+        cout << "9. Revenue Report\n";
         cout << "Enter your choice: ";
         cin >> choice;
 
@@ -308,13 +1034,18 @@ int main() {
                     Date startDate(startDay, startMonth, startYear);
                     Date endDate(endDay, endMonth, endYear);
                     hotel.bookRoom(roomId, customerId, startDate, endDate);
+                    cout << "Room booked successfully from " << startDate.toString() << " to " << endDate.toString() << ".\n";
                     break;
                 }
                 case 4: {
                     int roomId;
+                    int startDay, startMonth, startYear;
                     cout << "Enter room ID to cancel booking: ";
                     cin >> roomId;
-                    hotel.cancelBooking(roomId);
+                    cout << "Enter start date of the booking (day month year): ";
+                    cin >> startDay >> startMonth >> startYear;
+                    hotel.cancelBooking(roomId, Date(startDay, startMonth, startYear));
+                    cout << "Booking cancelled successfully.\n";
                     break;
                 }
                 case 5: {
@@ -325,9 +1056,24 @@ int main() {
                     hotel.listCustomers();
                     break;
                 }
+                case 9: {
+                    int startDay, startMonth, startYear;
+                    int endDay, endMonth, endYear;
+                    cout << "Enter start date (day month year): ";
+                    cin >> startDay >> startMonth >> startYear;
+                    cout << "Enter end date (day month year): ";
+                    cin >> endDay >> endMonth >> endYear;
+                    hotel.printRevenueReport(Date(startDay, startMonth, startYear), Date(endDay, endMonth, endYear));
+                    break;
+                }
                 case 7:
                     cout << "Exiting...\n";
                     break;
+#ifdef ENABLE_INSTRUMENTATION
+                case 8:
+                    Instrumentation::dump(cout);
+                    break;
+#endif
                 default:
                     cout << "Invalid choice. Please try again.\n";
             }
@@ -338,3 +1084,4 @@ int main() {
 
     return 0;
 }
+#endif // NO_MAIN
@@ -1,12 +1,37 @@
 #include <bits/stdc++.h>
+#include "instrumentation.h"
+#include "output_buffer.h"
 using namespace std;
 
+// Exception classes
+class AccountNotFoundException : public runtime_error {
+public:
+    AccountNotFoundException(const string& msg) : runtime_error(msg) {}
+};
+
+class InsufficientFundsException : public runtime_error {
+public:
+    InsufficientFundsException(const string& msg) : runtime_error(msg) {}
+};
+
 // Base Account Class
 class Account {
 public:
-    Account(int number, double balance) : accountNumber(number), balance(balance) {}
+    Account(int number, double balance)
+        : accountNumber(number), balance(balance), versions(nullptr), spareVersion(nullptr) {}
 
-    virtual ~Account() = default;
+    Account(const Account&) = delete;
+    Account& operator=(const Account&) = delete;
+
+    virtual ~Account() {
+        BalanceVersion* version = versions.load(memory_order_relaxed);
+        while (version) {
+            BalanceVersion* prev = version->prev.load(memory_order_relaxed);
+            delete version;
+            version = prev;
+        }
+        delete spareVersion;
+    }
 
     int getAccountNumber() const { return accountNumber; }
     double getBalance() const { return balance; }
@@ -23,12 +48,12 @@ public:
             throw invalid_argument("Withdrawal amount must be positive.");
         }
         if (amount > balance) {
-            throw runtime_error("Insufficient funds.");
+            throw InsufficientFundsException("Insufficient funds.");
         }
         balance -= amount;
     }
 
-    virtual string getAccountType() const = 0;
+    virtual string_view getAccountType() const = 0;
 
     virtual void display() const {
         cout << "Account Number: " << accountNumber
@@ -36,9 +61,71 @@ public:
              << ", Balance: $" << balance << endl;
     }
 
+    // Allocate the node for the next publishVersion up front, so that publishing
+    // a balance that has already changed cannot fail
+    void reserveVersion() {
+        if (!spareVersion) spareVersion = new BalanceVersion(0, 0, nullptr);
+    }
+
+    // Record the current balance as committed at `seq` (called by Bank under its
+    // write lock, after reserveVersion)
+    void publishVersion(uint64_t seq) {
+        reserveVersion();
+        BalanceVersion* version = spareVersion;
+        spareVersion = nullptr;
+        version->seq = seq;
+        version->balance = balance;
+        version->prev.store(versions.load(memory_order_relaxed), memory_order_relaxed);
+        versions.store(version, memory_order_release);
+    }
+
+    // Balance as of snapshot `seq`; false if the account did not exist yet
+    bool balanceAt(uint64_t seq, double& out) const {
+        const BalanceVersion* version = versions.load(memory_order_acquire);
+        while (version && version->seq > seq) {
+            version = version->prev.load(memory_order_acquire);
+        }
+        if (!version) return false;
+        out = version->balance;
+        return true;
+    }
+
+    // Free versions older than the newest one visible at `oldestPinned`.
+    // No snapshot at or after `oldestPinned` ever walks past that version.
+    // Returns true if newer versions remain that a later reclaim may free.
+    bool reclaimVersions(uint64_t oldestPinned) {
+        BalanceVersion* head = versions.load(memory_order_relaxed);
+        BalanceVersion* version = head;
+        while (version && version->seq > oldestPinned) {
+            version = version->prev.load(memory_order_relaxed);
+        }
+        if (!version) return true;
+        BalanceVersion* stale = version->prev.exchange(nullptr, memory_order_relaxed);
+        while (stale) {
+            BalanceVersion* prev = stale->prev.load(memory_order_relaxed);
+            delete stale;
+            stale = prev;
+        }
+        return version != head;
+    }
+
 protected:
     int accountNumber;
     double balance;
+
+private:
+    // Committed balance history, newest first, read lock-free by snapshots
+    struct BalanceVersion {
+        BalanceVersion(uint64_t seq, double balance, BalanceVersion* prev)
+            : seq(seq), balance(balance), prev(prev) {}
+
+        uint64_t seq;
+        double balance;
+        atomic<BalanceVersion*> prev;
+    };
+
+    atomic<BalanceVersion*> versions;
+    BalanceVersion* spareVersion;   // from reserveVersion, not yet published
 };
 
 // Savings Account Class
@@ -46,7 +133,7 @@ class SavingsAccount : public Account {
 public:
     SavingsAccount(int number, double balance) : Account(number, balance) {}
 
-    string getAccountType() const override { return "Savings"; }
+    string_view getAccountType() const override { return "Savings"; }
 };
 
 // Current Account Class
@@ -54,7 +141,7 @@ class CurrentAccount : public Account {
 public:
     CurrentAccount(int number, double balance) : Account(number, balance) {}
 
-    string getAccountType() const override { return "Current"; }
+    string_view getAccountType() const override { return "Current"; }
 };
 
 // Transaction Class
@@ -85,77 +172,510 @@ private:
     time_t timestamp;
 };
 
+// Append-only segmented log. One writer appends while any number of readers
+// access indices below size(); elements never move once published. Segment k
+// holds kFirstSegment << k elements, so each new segment doubles the capacity
+// and the fixed segment table never runs out in practice.
+template <typename T>
+class AppendOnlyLog {
+public:
+    static const int kFirstSegmentBits = 12;
+    static const size_t kFirstSegment = size_t(1) << kFirstSegmentBits;
+    static const int kMaxSegments = 48;
+
+    AppendOnlyLog() : count(0) {
+        for (auto& segment : segments) segment.store(nullptr, memory_order_relaxed);
+    }
+
+    AppendOnlyLog(const AppendOnlyLog&) = delete;
+    AppendOnlyLog& operator=(const AppendOnlyLog&) = delete;
+
+    ~AppendOnlyLog() {
+        size_t n = count.load(memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            (*this)[i].~T();
+        }
+        for (auto& segment : segments) {
+            ::operator delete(segment.load(memory_order_relaxed));
+        }
+    }
+
+    // Single writer only: allocate the slot for the next push_back, so that a
+    // push_back of a nothrow-movable value cannot fail
+    void reserveNext() {
+        int segment = segmentOf(count.load(memory_order_relaxed));
+        if (segment >= kMaxSegments) {
+            throw length_error("Log capacity exceeded.");
+        }
+        if (!segments[segment].load(memory_order_relaxed)) {
+            T* block = static_cast<T*>(::operator new(sizeof(T) * (kFirstSegment << segment)));
+            segments[segment].store(block, memory_order_release);
+        }
+    }
+
+    // Single writer only
+    void push_back(const T& value) {
+        reserveNext();
+        size_t n = count.load(memory_order_relaxed);
+        new (&slot(n)) T(value);
+        count.store(n + 1, memory_order_release);
+    }
+
+    void push_back(T&& value) {
+        reserveNext();
+        size_t n = count.load(memory_order_relaxed);
+        new (&slot(n)) T(move(value));
+        count.store(n + 1, memory_order_release);
+    }
+
+    size_t size() const { return count.load(memory_order_acquire); }
+
+    const T& operator[](size_t i) const { return slot(i); }
+
+private:
+    static int segmentOf(size_t i) {
+        return 63 - __builtin_clzll((i >> kFirstSegmentBits) + 1);
+    }
+
+    T& slot(size_t i) const {
+        // Most logs never leave the first segment; skip the bit arithmetic there
+        if (i < kFirstSegment) return segments[0].load(memory_order_acquire)[i];
+        int segment = segmentOf(i);
+        size_t first = kFirstSegment * ((size_t(1) << segment) - 1);
+        return segments[segment].load(memory_order_acquire)[i - first];
+    }
+
+    atomic<T*> segments[kMaxSegments];
+    atomic<size_t> count;
+};
+
+// Compact change-data-capture record for one committed Bank mutation
+enum class BankEventType : uint8_t { Deposit, Withdrawal, Transfer };
+
+struct BankEvent {
+    uint64_t seq;              // Bank commit sequence; gaps mean dropped events
+    int64_t timestampNanos;    // steady_clock time of the commit
+    double amount;
+    int32_t fromAccount;
+    int32_t toAccount;         // -1 unless a transfer
+    BankEventType type;
+};
+
+// Bounded single-producer/single-consumer ring. The two indices sit on separate
+// cache lines, and each side caches the other's index so the shared line is only
+// re-read when the ring looks full (producer) or empty (consumer).
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        mask = rounded - 1;
+        slots.reset(new T[rounded]);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Producer only
+    bool tryPush(const T& value) {
+        size_t h = head.load(memory_order_relaxed);
+        if (h - cachedTail > mask) {
+            cachedTail = tail.load(memory_order_acquire);
+            if (h - cachedTail > mask) return false;
+        }
+        slots[h & mask] = value;
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer only: hand up to `maxBatch` items to `handler`, then release them
+    // all with a single index update. Returns the number consumed.
+    template <typename F>
+    size_t consume(F&& handler, size_t maxBatch) {
+        size_t t = tail.load(memory_order_relaxed);
+        if (cachedHead == t) {
+            cachedHead = head.load(memory_order_acquire);
+            if (cachedHead == t) return 0;
+        }
+        size_t n = min(cachedHead - t, maxBatch);
+        for (size_t i = 0; i < n; ++i) {
+            handler(slots[(t + i) & mask]);
+        }
+        tail.store(t + n, memory_order_release);
+        return n;
+    }
+
+private:
+    alignas(64) atomic<size_t> head{0};   // next slot to write
+    size_t cachedTail = 0;                 // producer's view of tail
+    alignas(64) atomic<size_t> tail{0};   // next slot to read
+    size_t cachedHead = 0;                 // consumer's view of head
+    alignas(64) size_t mask;
+    unique_ptr<T[]> slots;
+};
+
+// What a publisher does when the ring is full
+enum class Backpressure {
+    Block,   // wait for the consumer (stalls Bank writers)
+    Drop,    // discard the event and count it
+    Spill    // append the event to a file for later replay
+};
+
+// Stream of BankEvents from one Bank to one downstream consumer
+class BankEventStream {
+public:
+    BankEventStream(size_t capacity, Backpressure policy, const string& spillPath = "")
+        : ring(capacity), policy(policy), spillFile(nullptr) {
+        if (policy == Backpressure::Spill) {
+            spillFile = fopen(spillPath.c_str(), "ab");
+            if (!spillFile) {
+                throw runtime_error("Cannot open spill file " + spillPath);
+            }
+        }
+    }
+
+    BankEventStream(const BankEventStream&) = delete;
+    BankEventStream& operator=(const BankEventStream&) = delete;
+
+    ~BankEventStream() {
+        if (spillFile) fclose(spillFile);
+    }
+
+    // Producer side; Bank calls this under its write lock, so there is one producer
+    void publish(const BankEvent& event) {
+        if (ring.tryPush(event)) {
+            published.store(published.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            return;
+        }
+        switch (policy) {
+            case Backpressure::Block:
+                while (!ring.tryPush(event)) this_thread::yield();
+                published.store(published.load(memory_order_relaxed) + 1, memory_order_relaxed);
+                break;
+            case Backpressure::Drop:
+                dropped.store(dropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+                break;
+            case Backpressure::Spill:
+                // Flushed per event so a spilled event is on disk, not in stdio's
+                // buffer, once publish returns. The change is already committed, so
+                // a failed write is counted rather than thrown.
+                if (fwrite(&event, sizeof(event), 1, spillFile) == 1 && fflush(spillFile) == 0) {
+                    spilled.store(spilled.load(memory_order_relaxed) + 1, memory_order_relaxed);
+                } else {
+                    spillFailures.store(spillFailures.load(memory_order_relaxed) + 1, memory_order_relaxed);
+                }
+                break;
+        }
+    }
+
+    // Consumer side: process up to `maxBatch` events
+    template <typename F>
+    size_t consume(F&& handler, size_t maxBatch = 256) {
+        return ring.consume(forward<F>(handler), maxBatch);
+    }
+
+    uint64_t getPublished() const { return published.load(memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped.load(memory_order_relaxed); }
+    uint64_t getSpilled() const { return spilled.load(memory_order_relaxed); }
+    uint64_t getSpillFailures() const { return spillFailures.load(memory_order_relaxed); }
+
+private:
+    SpscRing<BankEvent> ring;
+    Backpressure policy;
+    FILE* spillFile;
+    atomic<uint64_t> published{0};
+    atomic<uint64_t> dropped{0};
+    atomic<uint64_t> spilled{0};
+    atomic<uint64_t> spillFailures{0};   // events lost because the spill write failed
+};
+
 // Bank Class
 class Bank {
 public:
+    // A pinned, consistent view of all balances and the journal prefix as of one
+    // commit. Writers keep committing while a snapshot is held; the versions it
+    // can see are kept alive until it is destroyed.
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept
+            : bank(other.bank), seq(other.seq), accountCount(other.accountCount),
+              journalLength(other.journalLength) {
+            other.bank = nullptr;
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        ~Snapshot() {
+            if (bank) bank->unpin(seq);
+        }
+
+        uint64_t getVersion() const { return seq; }
+        size_t getTransactionCount() const { return journalLength; }
+
+        bool getBalance(int accountNumber, double& balance) const {
+            for (size_t i = 0; i < accountCount; ++i) {
+                const Account* account = bank->accounts[i];
+                if (account->getAccountNumber() == accountNumber) {
+                    return account->balanceAt(seq, balance);
+                }
+            }
+            return false;
+        }
+
+        void displayAccounts(OutputFormat format = OutputFormat::Text) const {
+            static const RecordWriter::Column columns[] = {
+                {"Account Number", "account_number"}, {"Type", "type"}, {"Balance", "balance"}};
+            RecordWriter rows(OutputBuffer::standardOutput(), format);
+            rows.begin("", columns);
+            for (size_t i = 0; i < accountCount; ++i) {
+                const Account* account = bank->accounts[i];
+                double balance;
+                if (!account->balanceAt(seq, balance)) continue;
+                rows.field(account->getAccountNumber()).field(account->getAccountType()).money(balance);
+                rows.endRow();
+            }
+            rows.end();
+        }
+
+        void displayTransactions() const {
+            for (size_t i = 0; i < journalLength; ++i) {
+                cout << bank->transactions[i].transaction.toString() << endl;
+            }
+        }
+
+    private:
+        friend class Bank;
+
+        Snapshot(const Bank* bank, uint64_t seq, size_t accountCount, size_t journalLength)
+            : bank(bank), seq(seq), accountCount(accountCount), journalLength(journalLength) {}
+
+        const Bank* bank;
+        uint64_t seq;
+        size_t accountCount;
+        size_t journalLength;
+    };
+
     ~Bank() {
-        for (auto account : accounts) {
-            delete account;
+        for (size_t i = 0; i < accounts.size(); ++i) {
+            delete accounts[i];
         }
     }
 
     void addAccount(Account* account) {
+        INSTRUMENT_OP("Bank::addAccount");
+        lock_guard<mutex> lock(writeMutex);
+        uint64_t seq = commitSeq.load(memory_order_relaxed) + 1;
+        prepareChange(account);
+        accounts.reserveNext();
         accounts.push_back(account);
+        publishVersion(account, seq);
+        commit(seq);
     }
 
     Account* findAccount(int accountNumber) const {
-        for (auto account : accounts) {
-            if (account->getAccountNumber() == accountNumber) {
-                return account;
-            }
-        }
-        return nullptr;
+        INSTRUMENT_OP("Bank::findAccount");
+        return accountByNumber(accountNumber);
     }
 
-    void deposit(int accountNumber, double amount) {
-        Account* account = findAccount(accountNumber);
+    // Mutations return the commit sequence (snapshot version) they were published at
+    uint64_t deposit(int accountNumber, double amount) {
+        INSTRUMENT_OP("Bank::deposit");
+        lock_guard<mutex> lock(writeMutex);
+        Account* account = accountByNumber(accountNumber);
         if (!account) {
-            throw runtime_error("Account not found.");
+            throw AccountNotFoundException("Account not found.");
         }
+        uint64_t seq = commitSeq.load(memory_order_relaxed) + 1;
+        JournalEntry entry{seq, Transaction(accountNumber, -1, amount, "Deposit")};
+        prepareChange(account);
         account->deposit(amount);
-        transactions.push_back(Transaction(accountNumber, -1, amount, "Deposit"));
+        publishVersion(account, seq);
+        transactions.push_back(move(entry));
+        commit(seq);
+        publishEvent(BankEventType::Deposit, seq, accountNumber, -1, amount);
+        return seq;
     }
 
-    void withdraw(int accountNumber, double amount) {
-        Account* account = findAccount(accountNumber);
+    uint64_t withdraw(int accountNumber, double amount) {
+        INSTRUMENT_OP("Bank::withdraw");
+        lock_guard<mutex> lock(writeMutex);
+        Account* account = accountByNumber(accountNumber);
         if (!account) {
-            throw runtime_error("Account not found.");
+            throw AccountNotFoundException("Account not found.");
         }
+        uint64_t seq = commitSeq.load(memory_order_relaxed) + 1;
+        JournalEntry entry{seq, Transaction(accountNumber, -1, amount, "Withdrawal")};
+        prepareChange(account);
         account->withdraw(amount);
-        transactions.push_back(Transaction(accountNumber, -1, amount, "Withdrawal"));
+        publishVersion(account, seq);
+        transactions.push_back(move(entry));
+        commit(seq);
+        publishEvent(BankEventType::Withdrawal, seq, accountNumber, -1, amount);
+        return seq;
     }
 
-    void transfer(int fromAccountNumber, int toAccountNumber, double amount) {
-        Account* fromAccount = findAccount(fromAccountNumber);
-        Account* toAccount = findAccount(toAccountNumber);
+    uint64_t transfer(int fromAccountNumber, int toAccountNumber, double amount) {
+        INSTRUMENT_OP("Bank::transfer");
+        lock_guard<mutex> lock(writeMutex);
+        Account* fromAccount = accountByNumber(fromAccountNumber);
+        Account* toAccount = accountByNumber(toAccountNumber);
         if (!fromAccount || !toAccount) {
-            throw runtime_error("One or both accounts not found.");
+            throw AccountNotFoundException("One or both accounts not found.");
         }
+        uint64_t seq = commitSeq.load(memory_order_relaxed) + 1;
+        JournalEntry entry{seq, Transaction(fromAccountNumber, toAccountNumber, amount, "Transfer")};
+        prepareChange(fromAccount);
+        prepareChange(toAccount);
+        // withdraw checks the amount, so the deposit leg cannot fail after it
         fromAccount->withdraw(amount);
         toAccount->deposit(amount);
-        transactions.push_back(Transaction(fromAccountNumber, toAccountNumber, amount, "Transfer"));
+        // Both legs share one commit, so no snapshot sees a half-applied transfer
+        publishVersion(fromAccount, seq);
+        publishVersion(toAccount, seq);
+        transactions.push_back(move(entry));
+        commit(seq);
+        publishEvent(BankEventType::Transfer, seq, fromAccountNumber, toAccountNumber, amount);
+        return seq;
     }
 
-    void displayAccounts() const {
-        for (const auto& account : accounts) {
-            account->display();
-        }
+    // Publish every later deposit, withdrawal and transfer to `stream` (nullptr to
+    // stop). The stream must outlive the Bank or be detached first.
+    void setEventStream(BankEventStream* stream) {
+        lock_guard<mutex> lock(writeMutex);
+        events = stream;
+    }
+
+    // Pin the latest committed version; never blocks writers for the life of the snapshot
+    Snapshot snapshot() const {
+        INSTRUMENT_OP("Bank::snapshot");
+        return pinSnapshot();
+    }
+
+    void displayAccounts(OutputFormat format = OutputFormat::Text) const {
+        INSTRUMENT_OP("Bank::displayAccounts");
+        pinSnapshot().displayAccounts(format);
     }
 
     void displayTransactions() const {
-        for (const auto& transaction : transactions) {
-            cout << transaction.toString() << endl;
-        }
+        INSTRUMENT_OP("Bank::displayTransactions");
+        pinSnapshot().displayTransactions();
     }
 
 private:
-    vector<Account*> accounts;
-    vector<Transaction> transactions;
+    struct JournalEntry {
+        uint64_t seq;
+        Transaction transaction;
+    };
+
+    static const uint64_t kReclaimInterval = 64;
+
+    // Uninstrumented body of snapshot(), for the display methods
+    Snapshot pinSnapshot() const {
+        lock_guard<mutex> lock(pinMutex);
+        uint64_t seq = commitSeq.load(memory_order_acquire);
+        pinnedSeqs.insert(seq);
+        size_t accountCount = accounts.size();
+        // Entries committed after `seq` may already be appended; trim them off
+        size_t journalLength = transactions.size();
+        while (journalLength > 0 && transactions[journalLength - 1].seq > seq) {
+            --journalLength;
+        }
+        return Snapshot(this, seq, accountCount, journalLength);
+    }
+
+    // Uninstrumented lookup for use inside other operations, so that each public
+    // call is counted once
+    Account* accountByNumber(int accountNumber) const {
+        for (size_t i = 0; i < accounts.size(); ++i) {
+            if (accounts[i]->getAccountNumber() == accountNumber) {
+                return accounts[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Publish `seq` to readers and periodically drop versions no snapshot can reach
+    void commit(uint64_t seq) {
+        commitSeq.store(seq, memory_order_release);
+        if (++commitsSinceReclaim >= kReclaimInterval) {
+            commitsSinceReclaim = 0;
+            reclaimVersions();
+        }
+    }
+
+    // Everything a mutation of `account` can fail on (allocating its version node,
+    // the journal slot and room in changedAccounts) happens here, before the
+    // balance is touched, so a failed write leaves no trace
+    void prepareChange(Account* account) {
+        account->reserveVersion();
+        transactions.reserveNext();
+        if (changedAccounts.size() + 2 > changedAccounts.capacity()) {
+            changedAccounts.reserve(2 * changedAccounts.capacity() + 2);
+        }
+    }
+
+    // Cannot fail once prepareChange(account) has run
+    void publishVersion(Account* account, uint64_t seq) {
+        account->publishVersion(seq);
+        changedAccounts.push_back(account);
+    }
+
+    // Trim only the accounts that gained versions since the last reclaim. Those
+    // whose history a pinned snapshot still needs stay listed for the next one.
+    void reclaimVersions() {
+        uint64_t oldestPinned;
+        {
+            lock_guard<mutex> lock(pinMutex);
+            oldestPinned = pinnedSeqs.empty() ? commitSeq.load(memory_order_relaxed) : *pinnedSeqs.begin();
+        }
+        sort(changedAccounts.begin(), changedAccounts.end());
+        changedAccounts.erase(unique(changedAccounts.begin(), changedAccounts.end()), changedAccounts.end());
+        size_t kept = 0;
+        for (Account* account : changedAccounts) {
+            if (account->reclaimVersions(oldestPinned)) changedAccounts[kept++] = account;
+        }
+        changedAccounts.resize(kept);
+    }
+
+    void publishEvent(BankEventType type, uint64_t seq, int from, int to, double amount) {
+        if (!events) return;
+        BankEvent event{};
+        event.seq = seq;
+        event.timestampNanos = chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+        event.amount = amount;
+        event.fromAccount = from;
+        event.toAccount = to;
+        event.type = type;
+        events->publish(event);
+    }
+
+    void unpin(uint64_t seq) const {
+        lock_guard<mutex> lock(pinMutex);
+        pinnedSeqs.erase(pinnedSeqs.find(seq));
+    }
+
+    AppendOnlyLog<Account*> accounts;
+    AppendOnlyLog<JournalEntry> transactions;
+    vector<Account*> changedAccounts;    // may hold versions to reclaim; guarded by writeMutex
+    mutex writeMutex;                    // serializes writers only
+    atomic<uint64_t> commitSeq{0};       // latest version visible to snapshots
+    uint64_t commitsSinceReclaim = 0;
+    mutable mutex pinMutex;              // guards pinnedSeqs
+    mutable multiset<uint64_t> pinnedSeqs;
+    BankEventStream* events = nullptr;   // guarded by writeMutex
 };
 
+// Define NO_MAIN to include this file from another program (see benchmark.cpp)
+#ifndef NO_MAIN
 // Main Function
 int main() {
     Bank bank;
+#ifdef ENABLE_INSTRUMENTATION
+    Instrumentation::installDumpSignal(SIGUSR1);
+#endif
 
     while (true) {
         cout << "\nBanking System\n";
@@ -166,6 +686,9 @@ int main() {
         cout << "5. Transfer\n";
         cout << "6. View Transactions\n";
         cout << "7. Exit\n";
+#ifdef ENABLE_INSTRUMENTATION
+        cout << "8. Show Statistics\n";
+#endif
         int choice;
         cout << "Enter your choice: ";
         cin >> choice;
@@ -189,7 +712,11 @@ int main() {
                 cout << "Invalid account type." << endl;
             }
         } else if (choice == 2) {
-            bank.displayAccounts();
+            try {
+                bank.displayAccounts();
+            } catch (const exception& e) {
+                cout << "Error: " << e.what() << endl;
+            }
         } else if (choice == 3) {
             int accountNumber;
             double amount;
@@ -235,6 +762,10 @@ int main() {
             bank.displayTransactions();
         } else if (choice == 7) {
             break;
+#ifdef ENABLE_INSTRUMENTATION
+        } else if (choice == 8) {
+            Instrumentation::dump(cout);
+#endif
         } else {
             cout << "Invalid choice. Please try again." << endl;
         }
@@ -242,3 +773,4 @@ int main() {
 
     return 0;
 }
+#endif // NO_MAIN
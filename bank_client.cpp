@@ -0,0 +1,240 @@
+// Load generator for bank_server.cpp.
+//
+// Each connection runs on its own thread and keeps `--pipeline` requests in
+// flight: it writes a whole window of requests at once, then tops the window up
+// with one write per read of responses. Latency is measured from the write that
+// carried a request to the read that returned its response, and the run prints
+// one JSON line with requests/sec and p50/p99/p999 latency.
+//
+//     g++ -std=c++17 -O2 -pthread -o bank_client bank_client.cpp
+//     ./bank_client --connect unix:bank.sock --connections 8 --pipeline 32 --requests 200000
+
+#include <bits/stdc++.h>
+#include "bank_protocol.h"
+#include "instrumentation.h"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+struct ClientConfig {
+    BankEndpoint endpoint;
+    int connections = 4;
+    int pipeline = 16;              // requests in flight per connection
+    long requests = 100000;         // per connection
+    double readRatio = 0.5;         // share of Balance requests
+    int accounts = 1000;            // the server's accounts are numbered 0..accounts-1
+    uint64_t seed = 42;
+};
+
+void printUsage() {
+    cerr << "Usage: bank_client [--connect unix:PATH|tcp:PORT] [--connections N] [--pipeline N]\n"
+            "                   [--requests N] [--read-ratio R] [--accounts N] [--seed N]\n";
+}
+
+ClientConfig parseArgs(int argc, char* argv[]) {
+    ClientConfig config;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        }
+        if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+        string value = argv[++i];
+        if (arg == "--connect") {
+            config.endpoint = BankEndpoint::parse(value);
+        } else if (arg == "--connections") {
+            config.connections = stoi(value);
+        } else if (arg == "--pipeline") {
+            config.pipeline = stoi(value);
+        } else if (arg == "--requests") {
+            config.requests = stol(value);
+        } else if (arg == "--read-ratio") {
+            config.readRatio = stod(value);
+        } else if (arg == "--accounts") {
+            config.accounts = stoi(value);
+        } else if (arg == "--seed") {
+            config.seed = stoull(value);
+        } else {
+            throw invalid_argument("Unknown option " + arg);
+        }
+    }
+    if (config.connections <= 0 || config.pipeline <= 0 || config.requests <= 0 || config.accounts <= 0) {
+        throw invalid_argument("Sizes must be positive.");
+    }
+    if (config.readRatio < 0 || config.readRatio > 1) {
+        throw invalid_argument("Read ratio must be between 0 and 1.");
+    }
+    return config;
+}
+
+int connectTo(const BankEndpoint& endpoint) {
+    int fd;
+    int result;
+    if (endpoint.port) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(endpoint.port));
+        result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    } else {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, endpoint.unixPath.c_str(), sizeof(address.sun_path) - 1);
+        result = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+    if (result != 0) {
+        close(fd);
+        throw runtime_error("Cannot connect to " + endpoint.toString() + ": " + strerror(errno));
+    }
+    return fd;
+}
+
+void sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) throw runtime_error(string("Send failed: ") + strerror(errno));
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+struct ConnectionResult {
+    LatencyHistogram latency;
+    uint64_t completed = 0;
+    uint64_t failed = 0;           // any status other than Ok
+    string error;
+};
+
+void runConnection(const ClientConfig& config, int index, ConnectionResult& result) {
+    try {
+        int fd = connectTo(config.endpoint);
+        mt19937_64 rng(config.seed + static_cast<uint64_t>(index));
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        // Responses arrive in request order, so a ring indexed by id holds the
+        // send time of every request in flight
+        vector<int64_t> sentAt(config.pipeline);
+        vector<BankRequest> outgoing;
+        outgoing.reserve(config.pipeline);
+        vector<char> input(config.pipeline * sizeof(BankResponse));
+        size_t inputUsed = 0;
+        uint64_t sent = 0, received = 0;
+        const uint64_t total = static_cast<uint64_t>(config.requests);
+
+        auto nowNanos = [] {
+            return chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count();
+        };
+
+        while (received < total) {
+            outgoing.clear();
+            while (sent < total && sent - received < static_cast<uint64_t>(config.pipeline)) {
+                BankRequest request{};
+                request.id = sent++;
+                request.account = static_cast<int32_t>(rng() % config.accounts);
+                request.amount = 1.0;
+                if (coin(rng) < config.readRatio) {
+                    request.op = BankOp::Balance;
+                } else {
+                    switch (rng() % 3) {
+                        case 0: request.op = BankOp::Deposit; break;
+                        case 1: request.op = BankOp::Withdraw; break;
+                        default:
+                            request.op = BankOp::Transfer;
+                            request.toAccount = static_cast<int32_t>(rng() % config.accounts);
+                            break;
+                    }
+                }
+                outgoing.push_back(request);
+            }
+            if (!outgoing.empty()) {
+                int64_t now = nowNanos();
+                for (const BankRequest& request : outgoing) sentAt[request.id % config.pipeline] = now;
+                sendAll(fd, reinterpret_cast<const char*>(outgoing.data()),
+                        outgoing.size() * sizeof(BankRequest));
+            }
+
+            ssize_t n = recv(fd, input.data() + inputUsed, input.size() - inputUsed, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) throw runtime_error("Server closed the connection.");
+            inputUsed += static_cast<size_t>(n);
+            int64_t now = nowNanos();
+            size_t frames = inputUsed / sizeof(BankResponse);
+            for (size_t i = 0; i < frames; ++i) {
+                BankResponse response;
+                memcpy(&response, input.data() + i * sizeof(BankResponse), sizeof(response));
+                if (response.id != received) {
+                    throw runtime_error("Response " + to_string(response.id) + " out of order, expected " +
+                                        to_string(received));
+                }
+                result.latency.record(static_cast<uint64_t>(now - sentAt[response.id % config.pipeline]));
+                if (response.status != BankStatus::Ok) ++result.failed;
+                ++received;
+            }
+            size_t bytes = frames * sizeof(BankResponse);
+            memmove(input.data(), input.data() + bytes, inputUsed - bytes);
+            inputUsed -= bytes;
+        }
+        result.completed = received;
+        close(fd);
+    } catch (const exception& e) {
+        result.error = e.what();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ClientConfig config;
+    try {
+        config = parseArgs(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        printUsage();
+        return 1;
+    }
+
+    vector<ConnectionResult> results(config.connections);
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < config.connections; ++i) {
+        threads.emplace_back(runConnection, cref(config), i, ref(results[i]));
+    }
+    for (auto& t : threads) t.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    LatencyHistogram latency;
+    uint64_t completed = 0, failed = 0;
+    for (const ConnectionResult& result : results) {
+        if (!result.error.empty()) {
+            cerr << "Error: " << result.error << endl;
+            return 1;
+        }
+        latency.merge(result.latency);
+        completed += result.completed;
+        failed += result.failed;
+    }
+
+    cout << fixed << setprecision(3)
+         << "{\"endpoint\":\"" << config.endpoint.toString() << "\""
+         << ",\"connections\":" << config.connections
+         << ",\"pipeline\":" << config.pipeline
+         << ",\"read_ratio\":" << config.readRatio
+         << ",\"requests\":" << completed
+         << ",\"failed\":" << failed
+         << ",\"seconds\":" << seconds
+         << setprecision(0)
+         << ",\"requests_per_sec\":" << completed / seconds
+         << ",\"p50_ns\":" << latency.percentile(0.50)
+         << ",\"p99_ns\":" << latency.percentile(0.99)
+         << ",\"p999_ns\":" << latency.percentile(0.999)
+         << ",\"max_ns\":" << latency.max()
+         << "}" << endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Change-data-capture consumer example for the Bank in Ques_04.cpp.
+//
+// The main thread drives deposits and transfers as fast as it can while a
+// consumer thread drains the BankEventStream in batches, checks that commit
+// sequence numbers arrive in order, and measures end-to-end latency from commit
+// to consumption. `--source raw` publishes synthetic events straight into the
+// stream, bypassing Bank, to measure the ring on its own.
+//
+//     g++ -std=c++17 -O2 -pthread -o bank_events bank_events.cpp
+//     ./bank_events --events 5000000 --capacity 65536 --policy drop --batch 256
+
+#define NO_MAIN
+#include "Ques_04.cpp"
+
+struct EventsConfig {
+    long events = 2000000;
+    size_t capacity = 1 << 16;
+    size_t batch = 256;
+    Backpressure policy = Backpressure::Block;
+    string spillPath = "bank_events.spill";
+    int accounts = 1000;
+    bool rawSource = false;
+};
+
+void printUsage() {
+    cerr << "Usage: bank_events [--events N] [--capacity N] [--batch N]\n"
+            "                   [--policy block|drop|spill] [--spill-file PATH] [--accounts N]\n"
+            "                   [--source bank|raw]\n";
+}
+
+EventsConfig parseArgs(int argc, char* argv[]) {
+    EventsConfig config;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        }
+        if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+        string value = argv[++i];
+        if (arg == "--events") {
+            config.events = stol(value);
+        } else if (arg == "--capacity") {
+            config.capacity = stoul(value);
+        } else if (arg == "--batch") {
+            config.batch = stoul(value);
+        } else if (arg == "--accounts") {
+            config.accounts = stoi(value);
+        } else if (arg == "--spill-file") {
+            config.spillPath = value;
+        } else if (arg == "--source") {
+            if (value == "bank") config.rawSource = false;
+            else if (value == "raw") config.rawSource = true;
+            else throw invalid_argument("Unknown source " + value);
+        } else if (arg == "--policy") {
+            if (value == "block") config.policy = Backpressure::Block;
+            else if (value == "drop") config.policy = Backpressure::Drop;
+            else if (value == "spill") config.policy = Backpressure::Spill;
+            else throw invalid_argument("Unknown policy " + value);
+        } else {
+            throw invalid_argument("Unknown option " + arg);
+        }
+    }
+    if (config.events <= 0 || config.capacity == 0 || config.batch == 0 || config.accounts <= 1) {
+        throw invalid_argument("Sizes must be positive.");
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    EventsConfig config;
+    try {
+        config = parseArgs(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        printUsage();
+        return 1;
+    }
+
+    Bank bank;
+    for (int i = 0; i < config.accounts; ++i) {
+        bank.addAccount(new SavingsAccount(i, 1e12));
+    }
+    BankEventStream stream(config.capacity, config.policy, config.spillPath);
+    bank.setEventStream(&stream);
+
+    atomic<bool> producerDone(false);
+    LatencyHistogram latency;
+    uint64_t consumed = 0, outOfOrder = 0, lastSeq = 0;
+
+    // One clock read per batch: every event in a batch is stamped with the time
+    // the batch was picked up
+    thread consumer([&] {
+        while (true) {
+            int64_t now = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count();
+            size_t n = stream.consume([&](const BankEvent& event) {
+                if (event.seq <= lastSeq) ++outOfOrder;
+                lastSeq = event.seq;
+                latency.record(static_cast<uint64_t>(max<int64_t>(0, now - event.timestampNanos)));
+            }, config.batch);
+            consumed += n;
+            if (n == 0) {
+                if (producerDone.load(memory_order_acquire) &&
+                    consumed == stream.getPublished()) break;
+                this_thread::yield();
+            }
+        }
+    });
+
+    auto start = chrono::steady_clock::now();
+    mt19937_64 rng(42);
+    for (long i = 0; i < config.events; ++i) {
+        int account = static_cast<int>(rng() % config.accounts);
+        if (config.rawSource) {
+            BankEvent event{};
+            event.seq = static_cast<uint64_t>(i) + 1;
+            event.timestampNanos = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count();
+            event.amount = 1.0;
+            event.fromAccount = account;
+            event.toAccount = -1;
+            event.type = BankEventType::Deposit;
+            stream.publish(event);
+        } else if (i % 4 == 0) {
+            bank.deposit(account, 1.0);
+        } else {
+            bank.transfer(account, (account + 1) % config.accounts, 1.0);
+        }
+    }
+    double produceSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    producerDone.store(true, memory_order_release);
+    consumer.join();
+    double totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    bank.setEventStream(nullptr);
+
+    const char* policyNames[] = {"block", "drop", "spill"};
+    cout << fixed << setprecision(0)
+         << "{\"source\":\"" << (config.rawSource ? "raw" : "bank") << "\""
+         << ",\"policy\":\"" << policyNames[static_cast<int>(config.policy)] << "\""
+         << ",\"capacity\":" << config.capacity
+         << ",\"batch\":" << config.batch
+         << ",\"events\":" << config.events
+         << ",\"published\":" << stream.getPublished()
+         << ",\"consumed\":" << consumed
+         << ",\"dropped\":" << stream.getDropped()
+         << ",\"spilled\":" << stream.getSpilled()
+         << ",\"spill_failures\":" << stream.getSpillFailures()
+         << ",\"out_of_order\":" << outOfOrder
+         << ",\"produce_events_per_sec\":" << config.events / produceSeconds
+         << ",\"consume_events_per_sec\":" << consumed / totalSeconds
+         << ",\"p50_ns\":" << latency.percentile(0.50)
+         << ",\"p99_ns\":" << latency.percentile(0.99)
+         << ",\"p999_ns\":" << latency.percentile(0.999)
+         << ",\"max_ns\":" << latency.max()
+         << "}" << endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#ifndef BANK_PROTOCOL_H
+#define BANK_PROTOCOL_H
+
+// Wire format shared by bank_server.cpp and bank_client.cpp.
+//
+// Every request and every response is one fixed-size frame, so a reader never
+// needs a length prefix: it takes as many whole frames as have arrived and keeps
+// the remainder for the next read. Clients may pipeline any number of requests
+// without waiting; responses for one connection come back in request order and
+// echo the request id. Frames use host byte order, since both ends always run
+// on the same machine (Unix-domain or loopback socket).
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+enum class BankOp : uint8_t {
+    Ping,
+    Balance,    // account; replies with the balance and the snapshot version read
+    Deposit,    // account, amount
+    Withdraw,   // account, amount
+    Transfer    // account -> toAccount, amount
+};
+
+enum class BankStatus : uint8_t {
+    Ok,
+    NotFound,            // no such account
+    InsufficientFunds,
+    InvalidAmount,       // amount was not positive
+    BadRequest,          // unknown op
+    ServerError          // the server failed to apply the request (e.g. out of memory)
+};
+
+struct BankRequest {
+    uint64_t id;          // chosen by the client, echoed in the response
+    double amount;
+    int32_t account;
+    int32_t toAccount;    // transfers only
+    BankOp op;
+    uint8_t reserved[7];
+};
+
+struct BankResponse {
+    uint64_t id;
+    double balance;       // Balance only
+    uint64_t version;     // commit sequence the reply reflects
+    BankStatus status;
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(BankRequest) == 32, "BankRequest must stay 32 bytes on the wire");
+static_assert(sizeof(BankResponse) == 32, "BankResponse must stay 32 bytes on the wire");
+
+// Where the server listens: a Unix-domain socket path, or a loopback TCP port
+struct BankEndpoint {
+    std::string unixPath = "bank.sock";
+    int port = 0;          // non-zero selects TCP on 127.0.0.1
+
+    // Parse "unix:PATH" or "tcp:PORT"
+    static BankEndpoint parse(const std::string& text) {
+        BankEndpoint endpoint;
+        if (text.compare(0, 5, "unix:") == 0 && text.size() > 5) {
+            endpoint.unixPath = text.substr(5);
+        } else if (text.compare(0, 4, "tcp:") == 0) {
+            endpoint.port = std::stoi(text.substr(4));
+            if (endpoint.port <= 0 || endpoint.port > 65535) {
+                throw std::invalid_argument("Port out of range: " + text);
+            }
+        } else {
+            throw std::invalid_argument("Endpoint must be unix:PATH or tcp:PORT, got " + text);
+        }
+        return endpoint;
+    }
+
+    std::string toString() const {
+        return port ? "tcp:" + std::to_string(port) : "unix:" + unixPath;
+    }
+};
+
+#endif // BANK_PROTOCOL_H
@@ -0,0 +1,557 @@
+// Local socket server for the Bank in Ques_04.cpp.
+//
+// One I/O thread runs an epoll loop over a Unix-domain or loopback TCP listener
+// and every client connection, speaking the fixed-size frames in
+// bank_protocol.h. Whatever whole requests a connection has sent are handed to
+// the worker pool as one batch; while that batch runs the connection is not
+// read, so the next batch collects everything the client pipelined in the
+// meantime. Workers never touch sockets: they post responses to a completion
+// queue and wake the I/O thread through an eventfd, and the I/O thread writes
+// them out without blocking. A slow reader only grows its own output buffer,
+// and past a limit the server stops reading its requests until it catches up.
+// A client that shuts down its sending side still gets a response to every
+// whole request it sent; the connection closes once those are written.
+//
+//     g++ -std=c++17 -O2 -pthread -o bank_server bank_server.cpp
+//     ./bank_server --listen unix:bank.sock --workers 4 --accounts 1000
+
+#define NO_MAIN
+#include "Ques_04.cpp"
+#include "bank_protocol.h"
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+struct ServerConfig {
+    BankEndpoint endpoint;
+    int workers = 4;
+    int accounts = 1000;
+    double balance = 1e9;
+    size_t maxBatch = 256;                  // requests handed to a worker at once
+    size_t maxPendingOutput = 1 << 20;      // output buffered for a client before reads pause
+};
+
+void printUsage() {
+    cerr << "Usage: bank_server [--listen unix:PATH|tcp:PORT] [--workers N] [--accounts N]\n"
+            "                   [--balance X] [--max-batch N]\n";
+}
+
+ServerConfig parseArgs(int argc, char* argv[]) {
+    ServerConfig config;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        }
+        if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+        string value = argv[++i];
+        if (arg == "--listen") {
+            config.endpoint = BankEndpoint::parse(value);
+        } else if (arg == "--workers") {
+            config.workers = stoi(value);
+        } else if (arg == "--accounts") {
+            config.accounts = stoi(value);
+        } else if (arg == "--balance") {
+            config.balance = stod(value);
+        } else if (arg == "--max-batch") {
+            config.maxBatch = stoul(value);
+        } else {
+            throw invalid_argument("Unknown option " + arg);
+        }
+    }
+    if (config.workers <= 0 || config.accounts <= 0 || config.maxBatch == 0) {
+        throw invalid_argument("Sizes must be positive.");
+    }
+    return config;
+}
+
+// Requests from one connection, run in order by a single worker
+struct BankJob {
+    uint64_t connectionId;
+    vector<BankRequest> requests;
+};
+
+struct BankCompletion {
+    uint64_t connectionId;
+    vector<BankResponse> responses;
+};
+
+// Runs BankJobs against the Bank and reports each finished batch to `complete`
+class WorkerPool {
+public:
+    WorkerPool(Bank& bank, int workerCount, function<void(BankCompletion&&)> complete)
+        : bank(bank), complete(move(complete)) {
+        for (int i = 0; i < workerCount; ++i) {
+            workers.emplace_back([this] { run(); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() { stop(); }
+
+    void submit(BankJob&& job) {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            jobs.push_back(move(job));
+        }
+        queueReady.notify_one();
+    }
+
+    // Finish the queued jobs and join the workers
+    void stop() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+    }
+
+private:
+    void run() {
+        while (true) {
+            BankJob job;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = move(jobs.front());
+                jobs.pop_front();
+            }
+            BankCompletion done{job.connectionId, {}};
+            done.responses.reserve(job.requests.size());
+            // Consecutive balance reads share one snapshot; any write ends it so
+            // later reads in the batch see the client's own writes
+            optional<Bank::Snapshot> snapshot;
+            for (const BankRequest& request : job.requests) {
+                done.responses.push_back(execute(request, snapshot));
+            }
+            complete(move(done));
+        }
+    }
+
+    BankResponse execute(const BankRequest& request, optional<Bank::Snapshot>& snapshot) {
+        BankResponse response{};
+        response.id = request.id;
+        response.status = BankStatus::Ok;
+        if (request.op == BankOp::Ping) return response;
+        if (request.op == BankOp::Balance) {
+            if (!snapshot) snapshot.emplace(bank.snapshot());
+            response.version = snapshot->getVersion();
+            if (!snapshot->getBalance(request.account, response.balance)) {
+                response.status = BankStatus::NotFound;
+            }
+            return response;
+        }
+        if (request.op != BankOp::Deposit && request.op != BankOp::Withdraw &&
+            request.op != BankOp::Transfer) {
+            response.status = BankStatus::BadRequest;
+            return response;
+        }
+
+        snapshot.reset();
+        // Account only rejects amounts <= 0, which lets NaN through
+        if (!(request.amount > 0)) {
+            response.status = BankStatus::InvalidAmount;
+            return response;
+        }
+        // Anything Bank throws becomes a status; a worker must never let an
+        // exception escape, since that would terminate the whole server
+        try {
+            if (request.op == BankOp::Deposit) {
+                response.version = bank.deposit(request.account, request.amount);
+            } else if (request.op == BankOp::Withdraw) {
+                response.version = bank.withdraw(request.account, request.amount);
+            } else {
+                response.version = bank.transfer(request.account, request.toAccount, request.amount);
+            }
+        } catch (const invalid_argument&) {
+            response.status = BankStatus::InvalidAmount;
+        } catch (const AccountNotFoundException&) {
+            response.status = BankStatus::NotFound;
+        } catch (const InsufficientFundsException&) {
+            response.status = BankStatus::InsufficientFunds;
+        } catch (const exception&) {
+            response.status = BankStatus::ServerError;
+        }
+        return response;
+    }
+
+    Bank& bank;
+    function<void(BankCompletion&&)> complete;
+    vector<thread> workers;
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<BankJob> jobs;
+    bool stopping = false;
+};
+
+class BankServer {
+public:
+    BankServer(Bank& bank, const ServerConfig& config)
+        : config(config), listenFd(-1), wakeFd(-1), signalFd(-1), epollFd(-1),
+          pool(bank, config.workers, [this](BankCompletion&& done) { post(move(done)); }) {}
+
+    BankServer(const BankServer&) = delete;
+    BankServer& operator=(const BankServer&) = delete;
+
+    ~BankServer() {
+        pool.stop();   // no worker may post to wakeFd once it is closed
+        for (auto& entry : connections) close(entry.second->fd);
+        for (int fd : {listenFd, wakeFd, signalFd, epollFd}) {
+            if (fd >= 0) close(fd);
+        }
+        if (!config.endpoint.port) unlink(config.endpoint.unixPath.c_str());
+    }
+
+    // Serve until SIGINT or SIGTERM
+    void run() {
+        sigset_t stopSignals;
+        sigemptyset(&stopSignals);
+        sigaddset(&stopSignals, SIGINT);
+        sigaddset(&stopSignals, SIGTERM);
+        signalFd = signalfd(-1, &stopSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (signalFd < 0 || wakeFd < 0 || epollFd < 0) {
+            throw runtime_error(string("Cannot set up event loop: ") + strerror(errno));
+        }
+        listenFd = openListener();
+        watch(listenFd, kListenerTag, EPOLLIN);
+        watch(wakeFd, kWakeTag, EPOLLIN);
+        watch(signalFd, kSignalTag, EPOLLIN);
+        cerr << "Listening on " << config.endpoint.toString() << " with "
+             << config.workers << " workers" << endl;
+
+        epoll_event events[256];
+        bool running = true;
+        while (running) {
+            int n = epoll_wait(epollFd, events, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw runtime_error(string("epoll_wait failed: ") + strerror(errno));
+            }
+            for (int i = 0; i < n; ++i) {
+                uint64_t tag = events[i].data.u64;
+                if (tag == kListenerTag) {
+                    acceptClients();
+                } else if (tag == kWakeTag) {
+                    drainCompletions();
+                } else if (tag == kSignalTag) {
+                    running = false;
+                } else {
+                    auto found = connections.find(tag);
+                    if (found != connections.end()) handleClient(*found->second, events[i].events);
+                }
+            }
+        }
+    }
+
+    void printStats(ostream& out) const {
+        out << "{\"connections\":" << acceptedCount
+            << ",\"requests\":" << requestCount
+            << ",\"batches\":" << batchCount
+            << ",\"mean_batch\":" << fixed << setprecision(2)
+            << (batchCount ? double(requestCount) / batchCount : 0.0)
+            << "}" << endl;
+    }
+
+private:
+    // epoll tags below kFirstConnection name the server's own descriptors
+    static const uint64_t kListenerTag = 0;
+    static const uint64_t kWakeTag = 1;
+    static const uint64_t kSignalTag = 2;
+    static const uint64_t kFirstConnection = 3;
+
+    // Sent output smaller than this is left in place until the buffer empties
+    static const size_t kCompactBytes = 64 * 1024;
+
+    struct Connection {
+        int fd;
+        uint64_t id;
+        vector<char> input;      // one batch worth of receive buffer
+        size_t inputUsed = 0;    // received bytes not yet handed to a worker
+        vector<char> output;     // responses not yet accepted by the socket
+        size_t outputSent = 0;
+        uint32_t interest = 0;   // events registered with epoll; 0 when not registered
+        bool busy = false;       // a batch from this connection is with a worker
+        bool readClosed = false; // the client has sent everything it will send
+    };
+
+    int openListener() {
+        int fd;
+        if (config.endpoint.port) {
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(static_cast<uint16_t>(config.endpoint.port));
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(fd);
+                throw runtime_error(string("Cannot bind loopback port: ") + strerror(errno));
+            }
+        } else {
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (config.endpoint.unixPath.size() >= sizeof(address.sun_path)) {
+                close(fd);
+                throw invalid_argument("Socket path too long: " + config.endpoint.unixPath);
+            }
+            strcpy(address.sun_path, config.endpoint.unixPath.c_str());
+            unlink(address.sun_path);
+            if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(fd);
+                throw runtime_error("Cannot bind " + config.endpoint.unixPath + ": " + strerror(errno));
+            }
+        }
+        if (listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            throw runtime_error(string("listen failed: ") + strerror(errno));
+        }
+        return fd;
+    }
+
+    void watch(int fd, uint64_t tag, uint32_t interest) {
+        epoll_event event{};
+        event.events = interest;
+        event.data.u64 = tag;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            throw runtime_error(string("epoll_ctl failed: ") + strerror(errno));
+        }
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;   // EAGAIN, or a client that already gave up
+            if (config.endpoint.port) {
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+            auto connection = make_unique<Connection>();
+            connection->fd = fd;
+            connection->id = nextConnectionId++;
+            connection->input.resize(config.maxBatch * sizeof(BankRequest));
+            connection->interest = EPOLLIN | EPOLLRDHUP;
+            watch(fd, connection->id, connection->interest);
+            connections.emplace(connection->id, move(connection));
+            ++acceptedCount;
+        }
+    }
+
+    void handleClient(Connection& connection, uint32_t ready) {
+        if (ready & EPOLLERR) {
+            closeClient(connection);
+            return;
+        }
+        if ((ready & EPOLLOUT) && !flushOutput(connection)) return;
+        // End of input (RDHUP, or HUP when the client closed outright) still
+        // leaves earlier requests in the socket buffer; read them like any other
+        if ((ready & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) && !connection.readClosed) {
+            // Take at most one batch worth; the rest waits in the socket buffer
+            while (connection.inputUsed < connection.input.size()) {
+                ssize_t n = recv(connection.fd, connection.input.data() + connection.inputUsed,
+                                 connection.input.size() - connection.inputUsed, 0);
+                if (n > 0) {
+                    connection.inputUsed += static_cast<size_t>(n);
+                } else if (n == 0) {
+                    connection.readClosed = true;
+                    break;
+                } else if (errno == EINTR) {
+                    continue;
+                } else if (errno == EAGAIN) {
+                    break;
+                } else {
+                    closeClient(connection);
+                    return;
+                }
+            }
+            dispatch(connection);
+        }
+        settle(connection);
+    }
+
+    // Hand every whole request received so far to a worker as one batch
+    void dispatch(Connection& connection) {
+        size_t count = connection.inputUsed / sizeof(BankRequest);
+        if (connection.busy || count == 0) return;
+        BankJob job{connection.id, vector<BankRequest>(count)};
+        size_t bytes = count * sizeof(BankRequest);
+        memcpy(job.requests.data(), connection.input.data(), bytes);
+        // Keep a trailing partial frame for the next read
+        memmove(connection.input.data(), connection.input.data() + bytes, connection.inputUsed - bytes);
+        connection.inputUsed -= bytes;
+        connection.busy = true;
+        requestCount += count;
+        ++batchCount;
+        pool.submit(move(job));
+    }
+
+    // Worker side of the completion path: queue the responses and wake the loop
+    void post(BankCompletion&& done) {
+        bool wasEmpty;
+        {
+            lock_guard<mutex> lock(completionMutex);
+            wasEmpty = completions.empty();
+            completions.push_back(move(done));
+        }
+        if (wasEmpty) {
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+
+    void drainCompletions() {
+        uint64_t wakeups;
+        ssize_t ignored = read(wakeFd, &wakeups, sizeof(wakeups));
+        (void)ignored;
+        vector<BankCompletion> ready;
+        {
+            lock_guard<mutex> lock(completionMutex);
+            ready.swap(completions);
+        }
+        for (BankCompletion& done : ready) {
+            auto found = connections.find(done.connectionId);
+            if (found == connections.end()) continue;   // client left mid-batch
+            Connection& connection = *found->second;
+            const char* bytes = reinterpret_cast<const char*>(done.responses.data());
+            connection.output.insert(connection.output.end(), bytes,
+                                     bytes + done.responses.size() * sizeof(BankResponse));
+            connection.busy = false;
+            if (!flushOutput(connection)) continue;
+            dispatch(connection);
+            settle(connection);
+        }
+    }
+
+    // Write as much pending output as the socket takes; false if the client is gone
+    bool flushOutput(Connection& connection) {
+        while (connection.outputSent < connection.output.size()) {
+            ssize_t n = send(connection.fd, connection.output.data() + connection.outputSent,
+                             connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+            if (n > 0) {
+                connection.outputSent += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && errno == EAGAIN) {
+                break;
+            } else {
+                closeClient(connection);
+                return false;
+            }
+        }
+        if (connection.outputSent == connection.output.size()) {
+            connection.output.clear();
+            connection.outputSent = 0;
+        } else if (connection.outputSent >= kCompactBytes && connection.outputSent * 2 >= connection.output.size()) {
+            // A reader that never quite catches up would otherwise keep every byte
+            // ever sent. Dropping the sent prefix only once it is at least half the
+            // buffer keeps the copy no larger than what was sent since the last one.
+            connection.output.erase(connection.output.begin(), connection.output.begin() + connection.outputSent);
+            connection.outputSent = 0;
+        }
+        return true;
+    }
+
+    // After any progress on a connection: close it once a client that stopped
+    // sending has had its last batch run and every response written, otherwise
+    // wait for whatever it needs next
+    void settle(Connection& connection) {
+        if (connection.readClosed && !connection.busy && connection.outputSent == connection.output.size()) {
+            closeClient(connection);   // a trailing partial frame is dropped
+            return;
+        }
+        updateInterest(connection);
+    }
+
+    // Read only when no batch is in flight and the client is keeping up with
+    // its responses; wait for writability only while output is pending. The
+    // limit counts the whole buffer, sent prefix included, so it bounds memory.
+    // A connection waiting on nothing but its worker leaves epoll altogether,
+    // since a hung-up socket would otherwise report EPOLLHUP on every wait.
+    void updateInterest(Connection& connection) {
+        size_t pending = connection.output.size() - connection.outputSent;
+        uint32_t interest = 0;
+        if (!connection.busy && !connection.readClosed &&
+            connection.output.size() < config.maxPendingOutput) {
+            interest |= EPOLLIN | EPOLLRDHUP;
+        }
+        if (pending > 0) interest |= EPOLLOUT;
+        if (interest == connection.interest) return;
+        epoll_event event{};
+        event.events = interest;
+        event.data.u64 = connection.id;
+        int op = interest == 0 ? EPOLL_CTL_DEL : connection.interest == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        epoll_ctl(epollFd, op, connection.fd, &event);
+        connection.interest = interest;
+    }
+
+    void closeClient(Connection& connection) {
+        if (connection.interest) epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+        close(connection.fd);
+        connections.erase(connection.id);
+    }
+
+    ServerConfig config;
+    int listenFd;
+    int wakeFd;
+    int signalFd;
+    int epollFd;
+    unordered_map<uint64_t, unique_ptr<Connection>> connections;
+    uint64_t nextConnectionId = kFirstConnection;
+    uint64_t acceptedCount = 0;
+    uint64_t requestCount = 0;
+    uint64_t batchCount = 0;
+    mutex completionMutex;                  // guards completions
+    vector<BankCompletion> completions;
+    WorkerPool pool;                        // last, so workers stop before the rest is torn down
+};
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    try {
+        config = parseArgs(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        printUsage();
+        return 1;
+    }
+
+    // Block the stop signals before any thread starts so only the signalfd sees them
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+#ifdef ENABLE_INSTRUMENTATION
+    Instrumentation::installDumpSignal(SIGUSR1);
+#endif
+
+    Bank bank;
+    for (int i = 0; i < config.accounts; ++i) {
+        bank.addAccount(new SavingsAccount(i, config.balance));
+    }
+    try {
+        BankServer server(bank, config);
+        server.run();
+        server.printStats(cout);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,652 @@
+// Synthetic workload benchmark for Library, Hotel and Bank.
+//
+// Drives the three systems directly (no menus) with a seeded generator:
+// configurable population sizes, Zipfian key skew, read/write mix and thread
+// counts. Each run prints one JSON line with throughput, latency percentiles and
+// peak RSS so results can be diffed between commits.
+//
+//     g++ -std=c++17 -O2 -pthread -o benchmark benchmark.cpp
+//     ./benchmark --system bank --threads 1,2,4 --zipf 0.99 --read-ratio 0.8
+//     ./benchmark --system chain --shards 1,2,4,8 --threads 8
+//     ./benchmark --system footprint --items 1000000
+//     ./benchmark --system assign --items 300 --ops 20000
+//     ./benchmark --system holds --people 100000 --ops 200000
+
+#define NO_MAIN
+#include "Ques_01.cpp"
+#include "Ques_02.cpp"
+#include "Ques_04.cpp"
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+// Benchmark settings, filled from the command line
+struct BenchConfig {
+    string system = "all";
+    vector<int> threadCounts = {1};
+    vector<int> shardCounts = {1, 2, 4};   // HotelChain only
+    int properties = 64;                   // HotelChain only
+    int items = 10000;            // books / rooms / accounts
+    int people = 1000;            // members / customers
+    long opsPerThread = 200000;
+    double readRatio = 0.9;
+    double zipfTheta = 0.99;      // 0 = uniform
+    uint64_t seed = 42;
+};
+
+// Zipfian key generator over [0, n) (Gray et al., as used by YCSB). Ranks are
+// scrambled through a seeded permutation so hot keys are not clustered at the
+// front of the containers being searched.
+class ZipfianGenerator {
+public:
+    ZipfianGenerator(int n, double theta, uint64_t seed) : n(n), theta(theta), permutation(n) {
+        iota(permutation.begin(), permutation.end(), 0);
+        mt19937_64 rng(seed);
+        shuffle(permutation.begin(), permutation.end(), rng);
+        if (theta <= 0) return;
+        zetaN = 0;
+        for (int i = 1; i <= n; ++i) zetaN += 1.0 / pow(i, theta);
+        double zeta2 = 1.0 + 1.0 / pow(2, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+    }
+
+    int next(mt19937_64& rng) const {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        if (theta <= 0) return permutation[static_cast<int>(u * n) % n];
+        double uz = u * zetaN;
+        int rank;
+        if (uz < 1.0) {
+            rank = 0;
+        } else if (uz < 1.0 + pow(0.5, theta)) {
+            rank = 1;
+        } else {
+            rank = static_cast<int>(n * pow(eta * u - eta + 1.0, alpha));
+        }
+        return permutation[min(rank, n - 1)];
+    }
+
+private:
+    int n;
+    double theta;
+    double zetaN = 0, alpha = 0, eta = 0;
+    vector<int> permutation;
+};
+
+// One system under test. Implementations must be safe to call from several
+// threads; Library and Hotel are not thread-safe, so their drivers serialize
+// on a mutex, which is exactly what the scaling numbers should expose.
+class Workload {
+public:
+    virtual ~Workload() = default;
+    virtual string name() const = 0;
+    virtual void populate(const BenchConfig& config) = 0;
+    // Returns false if the operation was rejected (e.g. insufficient funds)
+    virtual bool read(int key, mt19937_64& rng) = 0;
+    virtual bool write(int key, mt19937_64& rng) = 0;
+};
+
+class LibraryWorkload : public Workload {
+public:
+    string name() const override { return "library"; }
+
+    void populate(const BenchConfig& config) override {
+        people = config.people;
+        for (int i = 0; i < config.items; ++i) {
+            library.addBook(Book(i, "Title " + to_string(i), "Author " + to_string(i % 500)));
+        }
+        for (int i = 0; i < people; ++i) {
+            library.addMember(Member(i, "Member " + to_string(i)));
+        }
+        borrower.assign(config.items, -1);
+    }
+
+    bool read(int key, mt19937_64&) override {
+        lock_guard<mutex> lock(libraryMutex);
+        return library.findBook(key).getId() == key;
+    }
+
+    // Issue the book if it is on the shelf, otherwise return it
+    bool write(int key, mt19937_64& rng) override {
+        lock_guard<mutex> lock(libraryMutex);
+        if (borrower[key] < 0) {
+            int member = static_cast<int>(rng() % people);
+            library.issueBook(key, member);
+            borrower[key] = member;
+        } else {
+            library.returnBook(key, borrower[key]);
+            borrower[key] = -1;
+        }
+        return true;
+    }
+
+private:
+    Library library;
+    mutex libraryMutex;
+    vector<int> borrower;         // member holding each book, or -1
+    int people = 0;
+};
+
+class HotelWorkload : public Workload {
+public:
+    string name() const override { return "hotel"; }
+
+    void populate(const BenchConfig& config) override {
+        people = config.people;
+        for (int i = 0; i < config.items; ++i) {
+            double price = 80 + (i % 7) * 20;
+            switch (i % 3) {
+                case 0: hotel.addRoom(make_shared<SingleRoom>(i, price)); break;
+                case 1: hotel.addRoom(make_shared<DoubleRoom>(i, price)); break;
+                default: hotel.addRoom(make_shared<SuiteRoom>(i, price)); break;
+            }
+        }
+        for (int i = 0; i < people; ++i) {
+            hotel.addCustomer(make_shared<Customer>(i, "Customer " + to_string(i)));
+        }
+        bookedDay.assign(config.items, 0);
+    }
+
+    bool read(int key, mt19937_64&) override {
+        lock_guard<mutex> lock(hotelMutex);
+        return hotel.findRoom(key)->getId() == key;
+    }
+
+    // Book the room if it is free, otherwise cancel its booking
+    bool write(int key, mt19937_64& rng) override {
+        lock_guard<mutex> lock(hotelMutex);
+        if (!bookedDay[key]) {
+            int day = 1 + static_cast<int>(rng() % 20);
+            hotel.bookRoom(key, static_cast<int>(rng() % people),
+                           Date(day, 6, 2025), Date(day + 1 + static_cast<int>(rng() % 7), 6, 2025));
+            bookedDay[key] = day;
+        } else {
+            hotel.cancelBooking(key, Date(bookedDay[key], 6, 2025));
+            bookedDay[key] = 0;
+        }
+        return true;
+    }
+
+private:
+    Hotel hotel;
+    mutex hotelMutex;
+    vector<int> bookedDay;    // start day in June of each room's stay, 0 when free
+    int people = 0;
+};
+
+// HotelChain is thread-safe by construction: each request is posted to the
+// owning shard's worker and the client waits on the returned future. Rooms are
+// spread round-robin over the properties (key k is room k / P of property k % P).
+class ChainWorkload : public Workload {
+public:
+    explicit ChainWorkload(int shardCount) : chain(shardCount) {}
+
+    string name() const override { return "chain"; }
+
+    void populate(const BenchConfig& config) override {
+        properties = config.properties;
+        people = config.people;
+        vector<future<void>> pending;
+        for (int p = 0; p < properties; ++p) {
+            pending.push_back(chain.addProperty(p));
+        }
+        for (auto& done : pending) done.get();
+        pending.clear();
+        for (int i = 0; i < config.items; ++i) {
+            int roomId = i / properties;
+            double price = 80 + (i % 7) * 20;
+            shared_ptr<Room> room;
+            switch (i % 3) {
+                case 0: room = make_shared<SingleRoom>(roomId, price); break;
+                case 1: room = make_shared<DoubleRoom>(roomId, price); break;
+                default: room = make_shared<SuiteRoom>(roomId, price); break;
+            }
+            pending.push_back(chain.addRoom(i % properties, room));
+        }
+        for (auto& done : pending) done.get();
+        for (int i = 0; i < people; ++i) {
+            chain.addCustomer(make_shared<Customer>(i, "Customer " + to_string(i)));
+        }
+        bookedDay.reset(new atomic<int>[config.items]);
+        for (int i = 0; i < config.items; ++i) bookedDay[i].store(0);
+    }
+
+    bool read(int key, mt19937_64&) override {
+        return chain.findRoom(key % properties, key / properties).get().roomId == key / properties;
+    }
+
+    // Book the room if it is free, otherwise cancel its booking. Two clients can
+    // race on one key and reach the shard out of order; that shows up as rejected.
+    bool write(int key, mt19937_64& rng) override {
+        int newDay = 1 + static_cast<int>(rng() % 20);
+        int oldDay = bookedDay[key].load();
+        while (!bookedDay[key].compare_exchange_weak(oldDay, oldDay ? 0 : newDay)) {}
+        try {
+            if (!oldDay) {
+                chain.bookRoom(key % properties, key / properties, static_cast<int>(rng() % people),
+                               Date(newDay, 6, 2025), Date(newDay + 1 + static_cast<int>(rng() % 7), 6, 2025)).get();
+            } else {
+                chain.cancelBooking(key % properties, key / properties, Date(oldDay, 6, 2025)).get();
+            }
+        } catch (const runtime_error&) {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    HotelChain chain;
+    unique_ptr<atomic<int>[]> bookedDay;    // start day in June of each room's stay, 0 when free
+    int properties = 0;
+    int people = 0;
+};
+
+// Bank is safe for concurrent use: reads go through lock-free snapshots and
+// writes serialize inside Bank itself
+class BankWorkload : public Workload {
+public:
+    string name() const override { return "bank"; }
+
+    void populate(const BenchConfig& config) override {
+        items = config.items;
+        for (int i = 0; i < items; ++i) {
+            if (i % 2) {
+                bank.addAccount(new CurrentAccount(i, 1000000));
+            } else {
+                bank.addAccount(new SavingsAccount(i, 1000000));
+            }
+        }
+    }
+
+    bool read(int key, mt19937_64&) override {
+        double balance;
+        return bank.snapshot().getBalance(key, balance);
+    }
+
+    // Mostly transfers to a uniformly chosen account, with some deposits
+    bool write(int key, mt19937_64& rng) override {
+        try {
+            if (rng() % 4 == 0) {
+                bank.deposit(key, 1 + static_cast<double>(rng() % 100));
+            } else {
+                bank.transfer(key, static_cast<int>(rng() % items), 1 + static_cast<double>(rng() % 100));
+            }
+        } catch (const runtime_error&) {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    Bank bank;
+    int items = 0;
+};
+
+struct RunResult {
+    long ops = 0;
+    long rejected = 0;
+    double seconds = 0;
+    LatencyHistogram readLatency;
+    LatencyHistogram writeLatency;
+};
+
+RunResult runWorkload(Workload& workload, const BenchConfig& config, const ZipfianGenerator& keys, int threadCount) {
+    vector<RunResult> perThread(threadCount);
+    vector<thread> threads;
+    atomic<int> ready(0);
+    atomic<bool> go(false);
+
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            mt19937_64 rng(config.seed * 7919 + t);
+            RunResult& result = perThread[t];
+            ++ready;
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            for (long i = 0; i < config.opsPerThread; ++i) {
+                int key = keys.next(rng);
+                bool isRead = uniform_real_distribution<double>(0.0, 1.0)(rng) < config.readRatio;
+                auto start = chrono::steady_clock::now();
+                bool ok = isRead ? workload.read(key, rng) : workload.write(key, rng);
+                uint64_t nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+                (isRead ? result.readLatency : result.writeLatency).record(nanos);
+                if (!ok) ++result.rejected;
+            }
+            result.ops = config.opsPerThread;
+        });
+    }
+
+    while (ready.load() < threadCount) this_thread::yield();
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& t : threads) t.join();
+
+    RunResult total;
+    total.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (const auto& result : perThread) {
+        total.ops += result.ops;
+        total.rejected += result.rejected;
+        total.readLatency.merge(result.readLatency);
+        total.writeLatency.merge(result.writeLatency);
+    }
+    return total;
+}
+
+// Peak resident memory since the last resetPeakRss (VmHWM). Falls back to the
+// process-lifetime peak where /proc does not report it.
+long peakRssKb() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return stol(line.substr(6));
+    }
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Start a new peak-RSS window so each run reports its own peak rather than the
+// largest of every run before it. Memory freed by earlier runs is handed back
+// to the kernel first so it does not count against the next one.
+void resetPeakRss() {
+    malloc_trim(0);
+    ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5" << flush;
+}
+
+long currentRssKb() {
+    long pages = 0, residentPages = 0;
+    ifstream statm("/proc/self/statm");
+    statm >> pages >> residentPages;
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Resident memory taken by a Library of `items` books and `people` members, with
+// realistic title lengths and author names repeated across many books
+void measureLibraryFootprint(const BenchConfig& config) {
+    resetPeakRss();
+    long before = currentRssKb();
+    auto start = chrono::steady_clock::now();
+    {
+        Library library;
+        for (int i = 0; i < config.items; ++i) {
+            library.addBook(Book(i, "Collected Stories, Volume " + to_string(i),
+                                 "Author Name " + to_string(i % 5000)));
+        }
+        for (int i = 0; i < config.people; ++i) {
+            library.addMember(Member(i, "Member Name " + to_string(i % 5000)));
+        }
+        long after = currentRssKb();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << fixed << setprecision(1)
+             << "{\"system\":\"footprint\""
+             << ",\"books\":" << config.items
+             << ",\"members\":" << config.people
+             << ",\"rss_delta_kb\":" << after - before
+             << ",\"bytes_per_book\":" << (after - before) * 1024.0 / config.items
+             << ",\"seconds\":" << setprecision(3) << seconds
+             << ",\"peak_rss_kb\":" << peakRssKb()
+             << "}" << endl;
+    }
+}
+
+// `shardCount` is only reported for the sharded chain (0 elsewhere)
+void printResult(const string& system, const BenchConfig& config, int threadCount, int shardCount,
+                 const RunResult& result) {
+    LatencyHistogram all;
+    all.merge(result.readLatency);
+    all.merge(result.writeLatency);
+    cout << fixed << setprecision(3)
+         << "{\"system\":\"" << system << "\""
+         << ",\"threads\":" << threadCount;
+    if (shardCount > 0) {
+        cout << ",\"shards\":" << shardCount << ",\"properties\":" << config.properties;
+    }
+    cout
+         << ",\"items\":" << config.items
+         << ",\"people\":" << config.people
+         << ",\"read_ratio\":" << config.readRatio
+         << ",\"zipf_theta\":" << config.zipfTheta
+         << ",\"seed\":" << config.seed
+         << ",\"ops\":" << result.ops
+         << ",\"rejected\":" << result.rejected
+         << ",\"seconds\":" << result.seconds
+         << setprecision(0)
+         << ",\"ops_per_sec\":" << result.ops / result.seconds
+         << ",\"p50_ns\":" << all.percentile(0.50)
+         << ",\"p99_ns\":" << all.percentile(0.99)
+         << ",\"p999_ns\":" << all.percentile(0.999)
+         << ",\"max_ns\":" << all.max()
+         << ",\"read_p99_ns\":" << result.readLatency.percentile(0.99)
+         << ",\"write_p99_ns\":" << result.writeLatency.percentile(0.99)
+         << ",\"peak_rss_kb\":" << peakRssKb()
+         << "}" << endl;
+}
+
+void printUsage() {
+    cerr << "Usage: benchmark [--system library|hotel|chain|bank|all|footprint|assign|holds] [--threads 1,2,4]\n"
+            "                 [--items N] [--people N] [--ops N-per-thread]\n"
+            "                 [--read-ratio R] [--zipf THETA] [--seed S]\n"
+            "                 [--shards 1,2,4] [--properties N]\n";
+}
+
+vector<int> parseList(const string& value) {
+    vector<int> list;
+    stringstream ss(value);
+    string item;
+    while (getline(ss, item, ',')) list.push_back(stoi(item));
+    return list;
+}
+
+BenchConfig parseArgs(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            exit(0);
+        }
+        if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+        string value = argv[++i];
+        if (arg == "--system") {
+            config.system = value;
+        } else if (arg == "--threads") {
+            config.threadCounts = parseList(value);
+        } else if (arg == "--shards") {
+            config.shardCounts = parseList(value);
+        } else if (arg == "--properties") {
+            config.properties = stoi(value);
+        } else if (arg == "--items") {
+            config.items = stoi(value);
+        } else if (arg == "--people") {
+            config.people = stoi(value);
+        } else if (arg == "--ops") {
+            config.opsPerThread = stol(value);
+        } else if (arg == "--read-ratio") {
+            config.readRatio = stod(value);
+        } else if (arg == "--zipf") {
+            config.zipfTheta = stod(value);
+        } else if (arg == "--seed") {
+            config.seed = stoull(value);
+        } else {
+            throw invalid_argument("Unknown option " + arg);
+        }
+    }
+    if (config.items <= 0 || config.people <= 0 || config.opsPerThread <= 0 || config.properties <= 0) {
+        throw invalid_argument("Sizes must be positive.");
+    }
+    if (config.zipfTheta >= 1.0) {
+        throw invalid_argument("Zipf theta must be below 1.");
+    }
+    return config;
+}
+
+// Batch room assignment: best-fit Hotel::assignRooms against sequential
+// first-fit on identical hotels and the same random requests. assignRooms
+// handles requests in checkout order, so first-fit runs both in arrival order
+// and in that same checkout order; the latter isolates the room choice from
+// the ordering. `items` rooms, `ops` requests spread over a 90-day horizon.
+void measureAssignment(const BenchConfig& config) {
+    const char* types[] = {"Single", "Double", "Suite"};
+    const Date horizonStart(1, 6, 2025);
+    const int horizonDays = 90;
+
+    mt19937_64 rng(config.seed);
+    vector<BookingRequest> requests;
+    for (long i = 0; i < config.opsPerThread; ++i) {
+        long start = horizonStart.toDayNumber() + static_cast<long>(rng() % (horizonDays - 7));
+        long nights = 1 + static_cast<long>(rng() % 7);
+        requests.push_back(BookingRequest{static_cast<int>(rng() % config.people), types[rng() % 3],
+                                          100.0 + static_cast<double>(rng() % 121),
+                                          Date::fromDayNumber(start), Date::fromDayNumber(start + nights - 1)});
+    }
+
+    // Same order assignRooms uses: earliest checkout first, later arrival first on ties
+    vector<BookingRequest> byCheckout = requests;
+    stable_sort(byCheckout.begin(), byCheckout.end(), [](const BookingRequest& a, const BookingRequest& b) {
+        long lastA = a.endDate.toDayNumber(), lastB = b.endDate.toDayNumber();
+        if (lastA != lastB) return lastA < lastB;
+        return a.startDate.toDayNumber() > b.startDate.toDayNumber();
+    });
+
+    struct Run {
+        const char* strategy;
+        const char* order;
+        const vector<BookingRequest>* requests;
+    };
+    for (const Run& run : {Run{"best_fit", "checkout", &requests}, Run{"first_fit", "arrival", &requests},
+                           Run{"first_fit", "checkout", &byCheckout}}) {
+        string strategy = run.strategy;
+        Hotel hotel;
+        for (int i = 0; i < config.items; ++i) {
+            double price = 80 + (i % 7) * 20;
+            switch (i % 3) {
+                case 0: hotel.addRoom(make_shared<SingleRoom>(i, price)); break;
+                case 1: hotel.addRoom(make_shared<DoubleRoom>(i, price)); break;
+                default: hotel.addRoom(make_shared<SuiteRoom>(i, price)); break;
+            }
+        }
+        for (int i = 0; i < config.people; ++i) {
+            hotel.addCustomer(make_shared<Customer>(i, "Customer " + to_string(i)));
+        }
+
+        auto start = chrono::steady_clock::now();
+        vector<int> rooms = strategy == "best_fit" ? hotel.assignRooms(*run.requests)
+                                                   : hotel.assignRoomsFirstFit(*run.requests);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        long assigned = count_if(rooms.begin(), rooms.end(), [](int room) { return room >= 0; });
+        RevenueSummary summary = hotel.revenueSummary(
+            "", horizonStart, Date::fromDayNumber(horizonStart.toDayNumber() + horizonDays - 1));
+        cout << fixed << setprecision(4)
+             << "{\"system\":\"assign\""
+             << ",\"strategy\":\"" << strategy << "\""
+             << ",\"order\":\"" << run.order << "\""
+             << ",\"rooms\":" << config.items
+             << ",\"requests\":" << requests.size()
+             << ",\"assigned\":" << assigned
+             << ",\"fill_rate\":" << double(assigned) / requests.size()
+             << ",\"occupancy\":" << summary.occupancy()
+             << ",\"seconds\":" << seconds
+             << setprecision(0)
+             << ",\"requests_per_sec\":" << requests.size() / seconds
+             << "}" << endl;
+    }
+}
+
+// Hold-queue cost against queue length: one popular book whose holder keeps
+// returning it (handing it to the front of the queue) and re-joining at the back,
+// so the queue stays the same length, plus a position lookup per cycle
+void measureHolds(const BenchConfig& config) {
+    for (int length : {1, max(1, config.people / 100), config.people}) {
+        resetPeakRss();
+        Library library;
+        library.addBook(Book(0, "Popular Title", "Popular Author"));
+        for (int i = 0; i <= config.people; ++i) {
+            library.addMember(Member(i, "Member " + to_string(i)));
+        }
+
+        // Library reports every issue/return on cout; keep the JSON clean
+        cout.setstate(ios::badbit);
+        library.issueBook(0, 0);
+        for (int i = 1; i <= length; ++i) library.placeHold(0, i);
+
+        LatencyHistogram cycleLatency, positionLatency;
+        int holder = 0;
+        auto start = chrono::steady_clock::now();
+        for (long op = 0; op < config.opsPerThread; ++op) {
+            auto t0 = chrono::steady_clock::now();
+            library.returnBook(0, holder);
+            library.placeHold(0, holder);
+            auto t1 = chrono::steady_clock::now();
+            holder = (holder + 1) % (length + 1);   // the member the book was handed to
+            size_t position = library.holdPosition(0, (holder + length / 2) % (length + 1));
+            auto t2 = chrono::steady_clock::now();
+            if (position == 0 && length > 1) throw logic_error("Member lost its hold");
+            cycleLatency.record(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+            positionLatency.record(chrono::duration_cast<chrono::nanoseconds>(t2 - t1).count());
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout.clear();
+
+        cout << fixed << setprecision(0)
+             << "{\"system\":\"holds\""
+             << ",\"queue_length\":" << library.holdCount(0)
+             << ",\"cycles\":" << config.opsPerThread
+             << ",\"cycles_per_sec\":" << config.opsPerThread / seconds
+             << ",\"return_hold_p50_ns\":" << cycleLatency.percentile(0.50)
+             << ",\"return_hold_p99_ns\":" << cycleLatency.percentile(0.99)
+             << ",\"position_p50_ns\":" << positionLatency.percentile(0.50)
+             << ",\"position_p99_ns\":" << positionLatency.percentile(0.99)
+             << ",\"peak_rss_kb\":" << peakRssKb()
+             << "}" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    try {
+        config = parseArgs(argc, argv);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        printUsage();
+        return 1;
+    }
+
+    if (config.system == "footprint") {
+        measureLibraryFootprint(config);
+        return 0;
+    }
+    if (config.system == "assign") {
+        measureAssignment(config);
+        return 0;
+    }
+    if (config.system == "holds") {
+        measureHolds(config);
+        return 0;
+    }
+
+    ZipfianGenerator keys(config.items, config.zipfTheta, config.seed);
+
+    for (string system : {"library", "hotel", "chain", "bank"}) {
+        if (config.system != "all" && config.system != system) continue;
+        vector<int> shardCounts = system == "chain" ? config.shardCounts : vector<int>{0};
+        for (int shardCount : shardCounts) {
+            for (int threadCount : config.threadCounts) {
+                resetPeakRss();
+                unique_ptr<Workload> workload;
+                if (system == "library") workload.reset(new LibraryWorkload());
+                else if (system == "hotel") workload.reset(new HotelWorkload());
+                else if (system == "chain") workload.reset(new ChainWorkload(shardCount));
+                else workload.reset(new BankWorkload());
+                workload->populate(config);
+
+                // Library reports every issue/return on cout; keep the JSON clean
+                cout.setstate(ios::badbit);
+                RunResult result = runWorkload(*workload, config, keys, threadCount);
+                cout.clear();
+                printResult(system, config, threadCount, shardCount, result);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,297 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Low-overhead per-operation counters and latency histograms.
+//
+// Build with -DENABLE_INSTRUMENTATION to turn the INSTRUMENT_OP macro on; without
+// it the macro expands to nothing. Each thread records into its own counters, and
+// dump() merges them on read, so the hot path never takes a lock or bounces a
+// shared cache line. Every call is counted, but only one call in
+// 2^INSTRUMENT_SAMPLE_SHIFT per thread reads the clock, which keeps the cost of
+// timing small next to operations that themselves take tens of nanoseconds.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#ifndef INSTRUMENT_SAMPLE_SHIFT
+#define INSTRUMENT_SAMPLE_SHIFT 4
+#endif
+
+// Log-linear (HDR-style) histogram of nanosecond latencies: every power of two is
+// split into 8 sub-buckets, so any recorded value is within 12.5% of its bucket.
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    LatencyHistogram() : buckets(kBucketCount, 0), total(0), maxValue(0) {}
+
+    static int bucketFor(uint64_t value) {
+        if (value < static_cast<uint64_t>(kSubBuckets)) return static_cast<int>(value);
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + static_cast<int>((value >> shift) & (kSubBuckets - 1));
+    }
+
+    // Representative value (bucket midpoint) for a bucket index
+    static uint64_t valueFor(int bucket) {
+        if (bucket < kSubBuckets) return static_cast<uint64_t>(bucket);
+        int shift = bucket / kSubBuckets - 1;
+        uint64_t lower = static_cast<uint64_t>(kSubBuckets + bucket % kSubBuckets) << shift;
+        return lower + ((uint64_t(1) << shift) >> 1);
+    }
+
+    void record(uint64_t value) {
+        ++buckets[bucketFor(value)];
+        ++total;
+        if (value > maxValue) maxValue = value;
+    }
+
+    void addBucket(int bucket, uint64_t n) {
+        buckets[bucket] += n;
+        total += n;
+        if (n && valueFor(bucket) > maxValue) maxValue = valueFor(bucket);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < kBucketCount; ++i) buckets[i] += other.buckets[i];
+        total += other.total;
+        if (other.maxValue > maxValue) maxValue = other.maxValue;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+
+    // Value at quantile q in [0, 1]
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(q * total));
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return valueFor(i);
+        }
+        return maxValue;
+    }
+
+private:
+    std::vector<uint64_t> buckets;
+    uint64_t total;
+    uint64_t maxValue;
+};
+
+// Process-wide registry of instrumented operations and per-thread counters
+class Instrumentation {
+public:
+    static const int kMaxOps = 128;
+
+    static Instrumentation& instance() {
+        static Instrumentation registry;
+        return registry;
+    }
+
+    // Assign a stable id to an operation name (called once per call site)
+    static int registerOp(const char* name) {
+        Instrumentation& self = instance();
+        std::lock_guard<std::mutex> lock(self.mutex);
+        for (size_t i = 0; i < self.opNames.size(); ++i) {
+            if (self.opNames[i] == name) return static_cast<int>(i);
+        }
+        if (self.opNames.size() >= static_cast<size_t>(kMaxOps)) return kMaxOps - 1;
+        self.opNames.push_back(name);
+        return static_cast<int>(self.opNames.size() - 1);
+    }
+
+    // True for the calls on this thread whose latency should be measured
+    static bool sampleNext() {
+        thread_local uint32_t tick = 0;
+        return (tick++ & ((1u << INSTRUMENT_SAMPLE_SHIFT) - 1)) == 0;
+    }
+
+    static void record(int op, bool failed) {
+        OpCounters& counters = localCounters(op);
+        bump(counters.count, 1);
+        if (failed) bump(counters.errors, 1);
+    }
+
+    static void record(int op, uint64_t nanos, bool failed) {
+        OpCounters& counters = localCounters(op);
+        bump(counters.count, 1);
+        bump(counters.totalNanos, nanos);
+        bump(counters.buckets[LatencyHistogram::bucketFor(nanos)], 1);
+        if (failed) bump(counters.errors, 1);
+    }
+
+    // Merge every thread's counters and print one line per operation
+    static void dump(std::ostream& out) {
+        Instrumentation& self = instance();
+        std::lock_guard<std::mutex> lock(self.mutex);
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - self.startTime).count();
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+
+        out << std::left << std::setw(34) << "operation" << std::right
+            << std::setw(12) << "count" << std::setw(9) << "errors"
+            << std::setw(13) << "ops/sec" << std::setw(11) << "mean(ns)"
+            << std::setw(11) << "p50(ns)" << std::setw(11) << "p99(ns)"
+            << std::setw(11) << "p999(ns)" << std::setw(12) << "max(ns)" << '\n';
+
+        for (size_t op = 0; op < self.opNames.size(); ++op) {
+            LatencyHistogram histogram;
+            uint64_t calls = 0, errors = 0, totalNanos = 0;
+            for (const auto& thread : self.threads) {
+                const OpCounters* counters = thread->ops[op].load(std::memory_order_acquire);
+                if (!counters) continue;
+                calls += counters->count.load(std::memory_order_relaxed);
+                errors += counters->errors.load(std::memory_order_relaxed);
+                totalNanos += counters->totalNanos.load(std::memory_order_relaxed);
+                for (int b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+                    histogram.addBucket(b, counters->buckets[b].load(std::memory_order_relaxed));
+                }
+            }
+            if (calls == 0) continue;
+            uint64_t samples = histogram.count() ? histogram.count() : 1;
+            out << std::left << std::setw(34) << self.opNames[op] << std::right
+                << std::setw(12) << calls << std::setw(9) << errors
+                << std::setw(13) << std::fixed << std::setprecision(0)
+                << (seconds > 0 ? calls / seconds : 0.0)
+                << std::setw(11) << totalNanos / samples
+                << std::setw(11) << histogram.percentile(0.50)
+                << std::setw(11) << histogram.percentile(0.99)
+                << std::setw(11) << histogram.percentile(0.999)
+                << std::setw(12) << histogram.max() << '\n';
+        }
+        out.flags(flags);
+        out.precision(precision);
+        out.flush();
+    }
+
+    // Dump to stderr whenever `signo` arrives. The handler only writes to a pipe;
+    // a background thread does the formatting outside signal context.
+    static void installDumpSignal(int signo) {
+        static int pipeFds[2] = {-1, -1};
+        if (pipeFds[0] != -1 || pipe(pipeFds) != 0) return;
+        static int writeFd = pipeFds[1];
+        std::thread([] {
+            char byte;
+            while (read(pipeFds[0], &byte, 1) == 1) {
+                dump(std::cerr);
+            }
+        }).detach();
+        std::signal(signo, [](int) {
+            char byte = 0;
+            ssize_t ignored = write(writeFd, &byte, 1);
+            (void)ignored;
+        });
+    }
+
+private:
+    // One thread's counters for one operation; written only by that thread
+    struct OpCounters {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> totalNanos{0};
+        std::atomic<uint64_t> buckets[LatencyHistogram::kBucketCount] = {};
+    };
+
+    struct ThreadCounters {
+        ThreadCounters() {
+            for (auto& op : ops) op.store(nullptr, std::memory_order_relaxed);
+        }
+        std::atomic<OpCounters*> ops[kMaxOps];
+        std::vector<std::unique_ptr<OpCounters>> owned;
+    };
+
+    Instrumentation() : startTime(std::chrono::steady_clock::now()) {}
+
+    // Single-writer increment: no locked read-modify-write on the hot path
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // Counters outlive their thread so dump() still sees work done by exited threads
+    static OpCounters& localCounters(int op) {
+        thread_local ThreadCounters* local = nullptr;
+        if (!local) {
+            Instrumentation& self = instance();
+            std::lock_guard<std::mutex> lock(self.mutex);
+            self.threads.emplace_back(new ThreadCounters());
+            local = self.threads.back().get();
+        }
+        OpCounters* counters = local->ops[op].load(std::memory_order_relaxed);
+        if (!counters) {
+            Instrumentation& self = instance();
+            std::lock_guard<std::mutex> lock(self.mutex);
+            local->owned.emplace_back(new OpCounters());
+            counters = local->owned.back().get();
+            local->ops[op].store(counters, std::memory_order_release);
+        }
+        return *counters;
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> opNames;
+    std::vector<std::unique_ptr<ThreadCounters>> threads;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+// Counts (and on sampled calls, times) the enclosing scope. An exception escaping
+// the scope counts as an error: more exceptions in flight on exit than on entry,
+// so a scope that runs during another exception's unwinding is not blamed for it.
+class OpTimer {
+public:
+    explicit OpTimer(int op)
+        : op(op), exceptionsOnEntry(std::uncaught_exceptions()), sampled(Instrumentation::sampleNext()) {
+        if (sampled) start = std::chrono::steady_clock::now();
+    }
+
+    ~OpTimer() {
+        bool failed = std::uncaught_exceptions() > exceptionsOnEntry;
+        if (!sampled) {
+            Instrumentation::record(op, failed);
+            return;
+        }
+        uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        Instrumentation::record(op, nanos, failed);
+    }
+
+    OpTimer(const OpTimer&) = delete;
+    OpTimer& operator=(const OpTimer&) = delete;
+
+private:
+    int op;
+    int exceptionsOnEntry;
+    bool sampled;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef ENABLE_INSTRUMENTATION
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+#define INSTRUMENT_OP(name)                                                          \
+    static const int INSTRUMENT_CONCAT(instrumentOpId_, __LINE__) =                  \
+        Instrumentation::registerOp(name);                                           \
+    OpTimer INSTRUMENT_CONCAT(instrumentTimer_, __LINE__)(                           \
+        INSTRUMENT_CONCAT(instrumentOpId_, __LINE__))
+#else
+#define INSTRUMENT_OP(name) do {} while (0)
+#endif
+
+#endif // INSTRUMENTATION_H
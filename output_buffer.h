@@ -0,0 +1,266 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+// Buffered output for the list and report commands.
+//
+// Rows are formatted straight into one reusable buffer (integers and decimals via
+// std::to_chars, no temporary strings) and written with a single write(2) per
+// buffer-full instead of a flush per row. RecordWriter lays the same rows out as
+// the original human-readable text, CSV, or JSON lines.
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+enum class OutputFormat { Text, Csv, JsonLines };
+
+class OutputBuffer {
+public:
+    static const size_t kDefaultCapacity = 64 * 1024;
+    static constexpr size_t kMinCapacity = 512;   // room for any single formatted number
+
+    explicit OutputBuffer(int fd, size_t capacity = kDefaultCapacity)
+        : fd(fd), capacity(std::max(capacity, kMinCapacity)), used(0), data(new char[this->capacity]) {}
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // A destructor must not throw, so a failed final write is only reported
+    ~OutputBuffer() {
+        try {
+            flush();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+
+    // Buffer for standard output, reused by every listing on the calling thread.
+    // One per thread, so concurrent listings never share half-filled rows.
+    static OutputBuffer& standardOutput() {
+        thread_local OutputBuffer out(STDOUT_FILENO);
+        return out;
+    }
+
+    OutputBuffer& append(std::string_view text) {
+        while (!text.empty()) {
+            if (used == capacity) flush();
+            size_t n = std::min(text.size(), capacity - used);
+            std::memcpy(data.get() + used, text.data(), n);
+            used += n;
+            text.remove_prefix(n);
+        }
+        return *this;
+    }
+
+    OutputBuffer& append(char c) {
+        if (used == capacity) flush();
+        data[used++] = c;
+        return *this;
+    }
+
+    OutputBuffer& appendInt(long long value) {
+        reserve(24);
+        used = std::to_chars(data.get() + used, data.get() + capacity, value).ptr - data.get();
+        return *this;
+    }
+
+    // Fixed-point with `decimals` digits after the point (e.g. money)
+    OutputBuffer& appendFixed(double value, int decimals) {
+        reserve(352);
+        used = std::to_chars(data.get() + used, data.get() + capacity, value,
+                             std::chars_format::fixed, decimals).ptr - data.get();
+        return *this;
+    }
+
+    // Same digits as an ostream with default flags and precision (%g, 6 significant)
+    OutputBuffer& appendGeneral(double value) {
+        reserve(32);
+        used = std::to_chars(data.get() + used, data.get() + capacity, value,
+                             std::chars_format::general, 6).ptr - data.get();
+        return *this;
+    }
+
+    // Write everything buffered so far. Anything pending on cout goes first so the
+    // two streams never interleave out of order. Interrupted writes are retried;
+    // any other failure drops the buffered rows and throws runtime_error.
+    void flush() {
+        if (used == 0) return;
+        if (fd == STDOUT_FILENO) std::cout.flush();
+        size_t written = 0;
+        while (written < used) {
+            ssize_t n = ::write(fd, data.get() + written, used - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                int error = n < 0 ? errno : EIO;
+                used = 0;
+                throw std::runtime_error(std::string("Output write failed: ") + std::strerror(error));
+            }
+            written += static_cast<size_t>(n);
+        }
+        used = 0;
+    }
+
+private:
+    void reserve(size_t n) {
+        if (capacity - used < n) flush();
+    }
+
+    int fd;
+    size_t capacity;
+    size_t used;
+    std::unique_ptr<char[]> data;
+};
+
+// Writes a table of rows in one OutputFormat. Text reproduces the
+// "Label: value, Label: value" lines the menus have always printed.
+class RecordWriter {
+public:
+    struct Column {
+        std::string_view label;   // text output
+        std::string_view key;     // CSV header and JSON key
+    };
+
+    RecordWriter(OutputBuffer& out, OutputFormat format)
+        : out(out), format(format), columns(nullptr), columnCount(0), index(0), written(0) {}
+
+    // Start a table; `title` is only printed in text form
+    template <size_t N>
+    void begin(std::string_view title, const Column (&tableColumns)[N]) {
+        columns = tableColumns;
+        columnCount = N;
+        if (format == OutputFormat::Text) {
+            if (!title.empty()) out.append(title).append('\n');
+        } else if (format == OutputFormat::Csv) {
+            for (size_t i = 0; i < N; ++i) {
+                if (i) out.append(',');
+                out.append(columns[i].key);
+            }
+            out.append('\n');
+        }
+    }
+
+    RecordWriter& field(long long value) {
+        if (prefix()) out.appendInt(value);
+        return *this;
+    }
+
+    RecordWriter& field(int value) { return field(static_cast<long long>(value)); }
+
+    RecordWriter& field(std::string_view value) {
+        if (!prefix()) return *this;
+        if (format == OutputFormat::Text) {
+            out.append(value);
+        } else if (format == OutputFormat::Csv) {
+            appendCsv(value);
+        } else {
+            appendJson(value);
+        }
+        return *this;
+    }
+
+    RecordWriter& field(const char* value) { return field(std::string_view(value)); }
+
+    // Text shows Yes/No, the machine formats true/false
+    RecordWriter& flag(bool value) {
+        if (!prefix()) return *this;
+        if (format == OutputFormat::Text) {
+            out.append(value ? "Yes" : "No");
+        } else {
+            out.append(value ? "true" : "false");
+        }
+        return *this;
+    }
+
+    // Text shows "$" and ostream-style digits, the machine formats two decimals
+    RecordWriter& money(double value) {
+        if (!prefix()) return *this;
+        if (format == OutputFormat::Text) {
+            out.append('$').appendGeneral(value);
+        } else {
+            out.appendFixed(value, 2);
+        }
+        return *this;
+    }
+
+    // No value for this column: left out of text, empty in CSV, null in JSON
+    RecordWriter& skip() {
+        if (format == OutputFormat::Text) {
+            ++index;
+        } else if (prefix()) {
+            if (format == OutputFormat::JsonLines) out.append("null");
+        }
+        return *this;
+    }
+
+    void endRow() {
+        if (format == OutputFormat::JsonLines) out.append('}');
+        out.append('\n');
+        index = 0;
+        written = 0;
+    }
+
+    void end() { out.flush(); }
+
+private:
+    // Emit whatever separates and labels the next column; false if there are
+    // more values than columns
+    bool prefix() {
+        if (index >= columnCount) return false;
+        const Column& column = columns[index++];
+        if (format == OutputFormat::Text) {
+            if (written) out.append(", ");
+            out.append(column.label).append(": ");
+        } else if (format == OutputFormat::Csv) {
+            if (index > 1) out.append(',');
+        } else {
+            out.append(written ? ",\"" : "{\"").append(column.key).append("\":");
+        }
+        ++written;
+        return true;
+    }
+
+    void appendCsv(std::string_view value) {
+        if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out.append(value);
+            return;
+        }
+        out.append('"');
+        for (char c : value) {
+            if (c == '"') out.append('"');
+            out.append(c);
+        }
+        out.append('"');
+    }
+
+    void appendJson(std::string_view value) {
+        static const char kHex[] = "0123456789abcdef";
+        out.append('"');
+        for (char c : value) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                out.append('\\').append(c);
+            } else if (u < 0x20) {
+                out.append("\\u00").append(kHex[u >> 4]).append(kHex[u & 15]);
+            } else {
+                out.append(c);
+            }
+        }
+        out.append('"');
+    }
+
+    OutputBuffer& out;
+    OutputFormat format;
+    const Column* columns;
+    size_t columnCount;
+    size_t index;     // next column in the current row
+    size_t written;   // values emitted in the current row
+};
+
+#endif // OUTPUT_BUFFER_H
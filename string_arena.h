@@ -0,0 +1,102 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+// Arena storage for the long-lived strings held by Book, Member and Customer.
+//
+// Strings are copied once into large chunks and handed out as string_views that
+// stay valid for the life of the process; nothing is ever moved or freed. Fields
+// that repeat heavily (authors, names, issue dates) are interned so each distinct
+// value is stored only once.
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Bump allocator for immutable character data
+class StringArena {
+public:
+    static const size_t kChunkSize = 64 * 1024;
+
+    StringArena() : cursor(nullptr), remaining(0), reserved(0) {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    std::string_view store(std::string_view text) {
+        if (text.empty()) return std::string_view();
+        char* destination;
+        if (text.size() > kChunkSize / 4) {
+            // Oversized strings get their own chunk so they do not waste the current one
+            chunks.emplace_back(new char[text.size()]);
+            reserved += text.size();
+            destination = chunks.back().get();
+        } else {
+            if (text.size() > remaining) {
+                chunks.emplace_back(new char[kChunkSize]);
+                reserved += kChunkSize;
+                cursor = chunks.back().get();
+                remaining = kChunkSize;
+            }
+            destination = cursor;
+            cursor += text.size();
+            remaining -= text.size();
+        }
+        std::memcpy(destination, text.data(), text.size());
+        return std::string_view(destination, text.size());
+    }
+
+    size_t bytesReserved() const { return reserved; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* cursor;
+    size_t remaining;
+    size_t reserved;
+};
+
+// Process-wide string storage. Safe to call from any thread.
+class StringPool {
+public:
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+
+    // Copy `text` into the arena without deduplication (e.g. mostly-unique titles)
+    std::string_view store(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return arena.store(text);
+    }
+
+    // Return the single stored copy of `text`, adding it on first use
+    std::string_view intern(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = interned.find(text);
+        if (it != interned.end()) return *it;
+        std::string_view stored = arena.store(text);
+        interned.insert(stored);
+        return stored;
+    }
+
+    size_t internedCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return interned.size();
+    }
+
+    size_t bytesReserved() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return arena.bytesReserved();
+    }
+
+private:
+    StringPool() = default;
+
+    mutable std::mutex mutex;
+    StringArena arena;
+    std::unordered_set<std::string_view> interned;
+};
+
+#endif // STRING_ARENA_H